@@ -403,6 +403,31 @@
   #define BAFSD_UNLOAD_FEEDRATE 640
     #define BAFSD_ATTEMPTS_NR 5
   #define BAFSD_SERIAL_PORT 2
+  #define BAFSD_RX_BUFFER_SIZE 32         // (bytes) Interrupt-fed receive buffer on AVR. Power of 2.
+  //#define BAFSD_SENSOR_EVENTS           // Device reports sensor edges. Unload / load in one move stopped on the edge.
+  #if ENABLED(BAFSD_SENSOR_EVENTS)
+    #define BAFSD_UNLOAD_SEARCH_DISTANCE 60 // (mm) Longest unload move while waiting for the sensor to clear
+  #endif
+  //#define BAFSD_FRAMED_LINK             // Binary frames with CRC16 and sequence IDs. ASCII is kept for older device firmware.
+  #if ENABLED(BAFSD_FRAMED_LINK)
+    #define BAFSD_FRAMED_BAUD 115200      // Baud rate to switch to once the device accepts framing
+  #endif
+  //#define BAFSD_LOOKAHEAD               // Find the next T in the queue / SD file and pre-stage its filament while printing
+  #if ENABLED(BAFSD_LOOKAHEAD)
+    #define BAFSD_STAGED_CHANGE_DURATION 2500 // (ms) Switch duration when the new port was pre-staged
+    #define BAFSD_LOOKAHEAD_BYTES 8192    // Bytes of the SD file scanned for the next T
+  #endif
+  //#define BAFSD_LEARN_SWITCH_TIME       // Time each port switch and start the grip assist when the device should be done. See M711.
+  //#define BAFSD_PROFILE                 // Per port min / avg / max / histogram of each swap phase. See M712. (~700 bytes RAM)
+  //#define BAFSD_ODOMETER                // Count the filament fed from each port and track what's left on its spool. See M713.
+  #if ENABLED(BAFSD_ODOMETER)
+    #define BAFSD_LOW_SPOOL_MM 5000       // (mm) Pause before swapping to a port with less than this left, 0 to never pause
+    #define BAFSD_ODOMETER_SAVE_INTERVAL 60 // (minutes) EEPROM save interval during print. A value of 0 will save the counts at end of print.
+  #endif
+  //#define BAFSD_FAILOVER                // Swap to a backup port when a spool runs out or won't load, without pausing. See M714.
+  #if ENABLED(BAFSD_FAILOVER)
+    #define BAFSD_BACKUP_PORTS { 2, -1, 0, -1 } // Backup for each port, -1 for none
+  #endif
 #endif
 
 // @section psu control
@@ -724,6 +749,11 @@
   #define MPC_MIN_AMBIENT_CHANGE 1.0f                 // (K/s) Modeled ambient temperature rate of change, when correcting model inaccuracies.
   #define MPC_STEADYSTATE 0.5f                        // (K/s) Temperature change rate for steady state logic to be enforced.
 
+  //#define MPC_FLOW_FEEDFORWARD                      // Heat for the filament flow of queued moves, before the flow changes.
+  #if ENABLED(MPC_FLOW_FEEDFORWARD)
+    #define MPC_FLOW_LOOKAHEAD 2.0f                   // (s) Time ahead to average the planned flow over. Longer for slow heaters.
+  #endif
+
   #define MPC_TUNING_POS { X_CENTER, Y_CENTER, 1.0f } // (mm) M306 Autotuning position, ideally bed center at first layer height.
   #define MPC_TUNING_END_Z 10.0f                      // (mm) M306 Autotuning final Z position.
 #endif
@@ -1260,6 +1290,11 @@
   #define JUNCTION_DEVIATION_MM 0.013 // (mm) Distance from real junction edge
   #define JD_HANDLE_SMALL_SEGMENTS    // Use curvature estimation instead of just the junction angle
                                       // for small segments (< 1mm) with large junction angles (> 135°).
+  //#define JD_CORNER_BLENDING        // Corner at the speed for the curve traced by the last few moves
+  #if ENABLED(JD_CORNER_BLENDING)
+    #define JD_BLENDING_TOLERANCE 0.02  // (mm) Max distance of the moves from the curve
+    #define JD_BLENDING_SEGMENTS 4      // Moves used to find the curve (3-8)
+  #endif
 #endif
 
 /**
@@ -528,6 +528,16 @@
 #define TEMP_SENSOR_AD8495_OFFSET 0.0
 #define TEMP_SENSOR_AD8495_GAIN   1.0
 
+/**
+ * Thermistor Table Index
+ * Build an index of each thermistor table at compile time to find the entries
+ * for an ADC reading without a binary search. Costs 2^bits bytes per sensor.
+ */
+//#define THERMISTOR_TABLE_INDEX
+#if ENABLED(THERMISTOR_TABLE_INDEX)
+  #define THERMISTOR_INDEX_BITS 7   // Slices of the ADC range (2^bits, 4-8)
+#endif
+
 /**
  * Controller Fan
  * To cool down the stepper drivers and MOSFETs.
@@ -1061,40 +1071,90 @@
 /**
  * Input Shaping -- EXPERIMENTAL
  *
- * Zero Vibration (ZV) Input Shaping for X and/or Y movements.
+ * Input Shaping for X, Y, Z and/or E movements. Each axis has its own frequency,
+ * damping and shaper type:
+ *
+ *   ZV   : 2 impulses over 1/2 period. Sharpest, but only cancels the tuned frequency.
+ *   ZVD  : 3 impulses over 1 period. Tolerates more frequency error.
+ *   MZV  : 3 impulses over 3/4 period. Between ZV and ZVD.
+ *   EI   : 3 impulses over 1 period. Tolerant to frequency drift, e.g., with a changing bed mass.
+ *   2HEI : 4 impulses over 3/2 periods. The most tolerant and the most smoothing.
  *
  * This option uses a lot of SRAM for the step buffer. The buffer size is
- * calculated automatically from SHAPING_FREQ_[XY], DEFAULT_AXIS_STEPS_PER_UNIT,
- * DEFAULT_MAX_FEEDRATE and ADAPTIVE_STEP_SMOOTHING. The default calculation can
- * be overridden by setting SHAPING_MIN_FREQ and/or SHAPING_MAX_FEEDRATE.
- * The higher the frequency and the lower the feedrate, the smaller the buffer.
- * If the buffer is too small at runtime, input shaping will have reduced
- * effectiveness during high speed movements.
+ * calculated automatically from SHAPING_FREQ_[XYZE], SHAPING_MAX_IMPULSES,
+ * DEFAULT_AXIS_STEPS_PER_UNIT, DEFAULT_MAX_FEEDRATE and ADAPTIVE_STEP_SMOOTHING.
+ * The default calculation can be overridden by setting SHAPING_MIN_FREQ and/or
+ * SHAPING_MAX_FEEDRATE. The higher the frequency and the lower the feedrate,
+ * the smaller the buffer. If the buffer is too small at runtime, input shaping
+ * will have reduced effectiveness during high speed movements.
  *
- * Tune with M593 D<factor> F<frequency>:
+ * Tune with M593 D<factor> F<frequency> T<type>:
  *
  *  D<factor>    Set the zeta/damping factor. If axes (X, Y, etc.) are not specified, set for all axes.
  *  F<frequency> Set the frequency. If axes (X, Y, etc.) are not specified, set for all axes.
- *  T[map]       Input Shaping type, 0:ZV, 1:EI, 2:2H EI (not implemented yet)
+ *  T<type>      Set the shaper type. 0:ZV, 1:EI, 2:2HEI, 3:ZVD, 4:MZV
  *  X<1>         Set the given parameters only for the X axis.
  *  Y<1>         Set the given parameters only for the Y axis.
+ *  Z<1>         Set the given parameters only for the Z axis.
+ *  E<1>         Set the given parameters only for the E axis.
+ *
+ * CoreXY and Markforged machines shape the A and B motors, so X and Y must both be enabled.
+ * Z shaping damps gantry bounce from fast Z moves such as Z-hops.
  */
 //#define INPUT_SHAPING_X
 //#define INPUT_SHAPING_Y
-#if EITHER(INPUT_SHAPING_X, INPUT_SHAPING_Y)
+//#define INPUT_SHAPING_Z
+//#define INPUT_SHAPING_E
+#if ANY(INPUT_SHAPING_X, INPUT_SHAPING_Y, INPUT_SHAPING_Z, INPUT_SHAPING_E)
   #if ENABLED(INPUT_SHAPING_X)
     #define SHAPING_FREQ_X  40          // (Hz) The default dominant resonant frequency on the X axis.
     #define SHAPING_ZETA_X  0.15f       // Damping ratio of the X axis (range: 0.0 = no damping to 1.0 = critical damping).
+    #define SHAPING_TYPE_X  ZV          // Shaper type of the X axis: ZV, ZVD, MZV, EI or 2HEI
   #endif
   #if ENABLED(INPUT_SHAPING_Y)
     #define SHAPING_FREQ_Y  40          // (Hz) The default dominant resonant frequency on the Y axis.
     #define SHAPING_ZETA_Y  0.15f       // Damping ratio of the Y axis (range: 0.0 = no damping to 1.0 = critical damping).
+    #define SHAPING_TYPE_Y  ZV          // Shaper type of the Y axis: ZV, ZVD, MZV, EI or 2HEI
   #endif
+  #if ENABLED(INPUT_SHAPING_Z)
+    #define SHAPING_FREQ_Z  40          // (Hz) The default dominant resonant frequency on the Z axis.
+    #define SHAPING_ZETA_Z  0.15f       // Damping ratio of the Z axis (range: 0.0 = no damping to 1.0 = critical damping).
+    #define SHAPING_TYPE_Z  ZV          // Shaper type of the Z axis: ZV, ZVD, MZV, EI or 2HEI
+  #endif
+  #if ENABLED(INPUT_SHAPING_E)
+    #define SHAPING_FREQ_E  40          // (Hz) The default dominant resonant frequency on the E axis.
+    #define SHAPING_ZETA_E  0.15f       // Damping ratio of the E axis (range: 0.0 = no damping to 1.0 = critical damping).
+    #define SHAPING_TYPE_E  ZV          // Shaper type of the E axis: ZV, ZVD, MZV, EI or 2HEI
+  #endif
+  #define SHAPING_MAX_IMPULSES 2        // Impulses of the largest shaper to allow: 2 (ZV), 3 (ZVD, MZV, EI) or 4 (2HEI).
+                                        // The step buffer grows with the time the shaper spans: x2 for 3, x3 for 4.
   //#define SHAPING_MIN_FREQ  20        // By default the minimum of the shaping frequencies. Override to affect SRAM usage.
   //#define SHAPING_MAX_STEPRATE 10000  // By default the maximum total step rate of the shaped axes. Override to affect SRAM usage.
   //#define SHAPING_MENU                // Add a menu to the LCD to set shaping parameters.
 #endif
 
+/**
+ * Fixed-Time Motion -- EXPERIMENTAL
+ *
+ * Sample each planner block at a fixed rate in the main loop and play the
+ * steps back from a buffer at a fixed stepper ISR rate. The ISR no longer
+ * computes the trapezoid, so its cost per tick is constant.
+ *
+ * - Endstops are not checked. Homing and probing switch back to the trapezoid ISR.
+ * - Linear Advance and Input Shaping are not applied while it's active.
+ * - Each axis steps at most once per ISR tick, so FTM_STEPPER_FS caps the step rate.
+ * - 32-bit boards only.
+ *
+ * Switch with M493 S<0|1>.
+ */
+//#define FT_MOTION
+#if ENABLED(FT_MOTION)
+  #define FTM_DEFAULT_ENABLED         // Use fixed-time motion at startup
+  #define FTM_FS               1000   // (Hz) Trajectory sample rate
+  #define FTM_STEPPER_FS      40000   // (Hz) Stepper ISR rate. A multiple of FTM_FS.
+  #define FTM_BUFFER_SIZE      2048   // ISR ticks buffered ahead (power of 2)
+#endif
+
 #define AXIS_RELATIVE_MODES { false, false, false, false }
 
 // Add a Duplicate option for well-separated conjoined nozzles
@@ -2290,10 +2350,15 @@
   #define N_ARC_CORRECTION       25   // Number of interpolated segments between corrections
   //#define ARC_P_CIRCLES             // Enable the 'P' parameter to specify complete circles
   //#define SF_ARC_FIX                // Enable only if using SkeinForge with "Arc Point" fillet procedure
+  //#define ARC_NATIVE_BLOCKS         // Plan each G2/G3 as one block traced by the stepper. Requires FT_MOTION.
 #endif
 
 // G5 Bézier Curve Support with XYZE destination and IJPQ offsets
 //#define BEZIER_CURVE_SUPPORT        // Requires ~2666 bytes
+#if ENABLED(BEZIER_CURVE_SUPPORT)
+  #define BEZIER_TOLERANCE      0.01  // (mm) Maximum distance between the curve and its segments
+  #define BEZIER_MIN_SEGMENT_MM 0.1   // (mm) Minimum length of each curve segment
+#endif
 
 #if EITHER(ARC_SUPPORT, BEZIER_CURVE_SUPPORT)
   //#define CNC_WORKSPACE_PLANES      // Allow G2/G3/G5 to operate in XY, ZX, or YZ planes
@@ -2368,6 +2433,15 @@
  */
 //#define MAXIMUM_STEPPER_RATE 250000
 
+/**
+ * Stepper ISR Profiler
+ * Measure the time spent in each phase of the stepper ISR and count the ISR overruns,
+ * to set feedrates and microstepping against the real headroom. Uses the DWT cycle
+ * counter on ARM and the host clock (ns) in the native simulator.
+ * Report with M494. Auto-report with M494 S<seconds>.
+ */
+//#define STEPPER_ISR_PROFILE
+
 // @section temperature
 
 // Control heater 0 and heater 1 in parallel.
@@ -2389,6 +2463,28 @@
   #define BLOCK_BUFFER_SIZE 16
 #endif
 
+// The number of newest moves that the lookahead can still speed up. Each needs 20 bytes (28 with PLANNER_FIXED_POINT).
+// Use fewer than BLOCK_BUFFER_SIZE to fit a deeper buffer in the same RAM. (Power of 2)
+//#define BLOCK_PLAN_SIZE 16
+
+// Plan with integer math instead of float, for boards with no FPU (AVR, Cortex-M0/M3).
+// Junction speeds are capped at 1024mm/s. MARLIN_TEST_BUILD checks it against the float math.
+//#define PLANNER_FIXED_POINT
+
+// With S_CURVE_ACCELERATION the planner breaks each speed ramp into this many pieces
+// and the Stepper ISR interpolates them instead of evaluating the Bézier curve. (4-16)
+// Each block needs about 10 bytes more per piece.
+//#define S_CURVE_RAMP_PIECES 8
+
+// Buffer runs of nearly collinear segments from Delta and mesh leveled moves as single
+// blocks, so the lookahead reaches further along long moves. The deviation is measured
+// where the planner steps, so on a Delta it's in tower mm. Not for SCARA.
+//#define COALESCE_SEGMENTS
+#if ENABLED(COALESCE_SEGMENTS)
+  #define COALESCE_TOLERANCE    0.005 // (mm) Furthest a segment end may be from the merged line
+  #define COALESCE_MAX_SEGMENTS     8 // Most segments to merge into one block
+#endif
+
 // @section serial
 
 // The ASCII buffer for serial input
@@ -275,7 +275,7 @@
   template <uint8_t serial>
   struct BAFSDSerialCfg {
     static constexpr int PORT               = serial;
-    static constexpr unsigned int RX_SIZE   = 8;
+    static constexpr unsigned int RX_SIZE   = BAFSD_RX_BUFFER_SIZE;
     static constexpr unsigned int TX_SIZE   = 8;
     static constexpr bool XONOFF            = false;
     static constexpr bool EMERGENCYPARSER   = false;
@@ -24,11 +24,18 @@
 #include "../../inc/MarlinConfig.h"
 #include "../shared/Delay.h"
 
+#if ENABLED(LINUX_BENCHMARK)
+  #include "benchmark.h"
+#endif
+
 // ------------------------
 // Serial ports
 // ------------------------
 
 MSerialT usb_serial(TERN0(EMERGENCY_PARSER, true));
+#ifdef BAFSD_SERIAL_PORT
+  MSerialT bafsd_serial(false);
+#endif
 
 // U8glib required functions
 extern "C" {
@@ -40,6 +47,10 @@ extern "C" {
 
 //************************//
 
+#if ENABLED(LINUX_BENCHMARK)
+  void MarlinHAL::idletask() { bench.idle(); }
+#endif
+
 // return free heap space
 int freeMemory() { return 0; }
 
@@ -73,6 +73,11 @@ uint8_t _getc();
 extern MSerialT usb_serial;
 #define MYSERIAL1 usb_serial
 
+#ifdef BAFSD_SERIAL_PORT
+  extern MSerialT bafsd_serial;
+  #define BAFSD_SERIAL bafsd_serial   // Wired to the emulated unit in hardware/BAFSDevice
+#endif
+
 //
 // Interrupts
 //
@@ -122,7 +127,11 @@ public:
   static void delay_ms(const int ms) { _delay_ms(ms); }
 
   // Tasks, called from idle()
-  static void idletask() {}
+  #if ENABLED(LINUX_BENCHMARK)
+    static void idletask();
+  #else
+    static void idletask() {}
+  #endif
 
   // Reset
   static constexpr uint8_t reset_reason = RST_POWER_ON;
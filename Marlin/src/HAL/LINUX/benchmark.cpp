@@ -0,0 +1,327 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2023 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#ifdef __PLAT_LINUX__
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(LINUX_BENCHMARK)
+
+#include "benchmark.h"
+#include "hardware/Heater.h"
+#include "hardware/LinearAxis.h"
+#include "hardware/Timer.h"
+#if HAS_BAFSD
+  #include "hardware/BAFSDevice.h"
+#endif
+
+#include "../../gcode/queue.h"
+#include "../../module/planner.h"
+#include "../../module/stepper.h"
+#include "../../module/temperature.h"
+
+#include <stdio.h>
+
+extern void setup();
+extern void loop();
+extern Timer timers[2];
+
+Benchmark bench;
+
+// The planned segments the stepper hasn't passed yet, in mm
+#define BENCH_SEGMENTS ((BLOCK_BUFFER_SIZE) * 2)
+#define SEG_MOD(n) ((n) & ((BENCH_SEGMENTS) - 1))
+
+typedef struct { xyz_pos_t start, end; } bench_segment_t;
+
+static bench_segment_t segments[BENCH_SEGMENTS];
+static uint16_t seg_head, seg_tail;
+
+static FILE *file;
+static char line[128];    // The line waiting for room in the serial buffer
+static bool at_eof;
+
+static Heater *heaters[2];
+static LinearAxis *axes[4];
+#if HAS_BAFSD
+  static BAFSDevice *bafs;
+#endif
+
+static HeaterModel models[2] = { Heater::hotend_model, Heater::bed_model };
+
+// A new heater target and the heater's response to it
+typedef struct {
+  uint8_t heater;
+  celsius_t from, target;
+  uint64_t start_ns, reached_ns, settled_ns;  // Settled is the last entry into the window
+  float overshoot, dip, lo, hi;               // Dip is the worst fall back once reached, e.g. under a flow step
+} thermal_step_t;
+
+static thermal_step_t thermal_steps[16];
+static thermal_step_t *step_now[2];
+static uint8_t step_count;
+static int32_t last_e;
+static uint64_t last_load_ns;
+
+static uint32_t commands, blocks, isr_count, underruns, dev_count;
+static uint64_t host_start, virtual_start, isr_host_ns, stall_ns;
+static bool stalled;
+static float dev_max;
+static double dev_sum_sq;
+
+// Put as many whole lines into the serial buffer as will fit
+void Benchmark::feed() {
+  for (;;) {
+    if (!line[0]) {
+      if (at_eof || !fgets(line, sizeof(line), file)) { at_eof = true; line[0] = '\0'; return; }
+      const size_t len = strlen(line);
+      if (line[len - 1] != '\n' && len < sizeof(line) - 1) strcat(line, "\n");
+      const char *c = line;
+      while (*c == ' ' || *c == '\t') c++;
+      if (*c != ';' && *c != '\n' && *c != '\r') commands++;
+    }
+    const size_t len = strlen(line);
+    if (usb_serial.receive_buffer.free() < len) return;
+    for (size_t i = 0; i < len; i++) usb_serial.receive_buffer.write(line[i]);
+    line[0] = '\0';
+  }
+}
+
+bool Benchmark::input_pending() {
+  return !at_eof || line[0] || usb_serial.available() || queue.has_commands_queued();
+}
+
+void Benchmark::block_planned(const xyze_long_t &start, const xyze_long_t &end) {
+  bench_segment_t &s = segments[seg_head];
+  LOOP_L_N(a, XYZ) {
+    s.start[a] = start[a] * planner.mm_per_step[a];
+    s.end[a] = end[a] * planner.mm_per_step[a];
+  }
+  seg_head = SEG_MOD(seg_head + 1);
+  if (seg_head == seg_tail) seg_tail = SEG_MOD(seg_tail + 1);
+  blocks++;
+}
+
+// Distance from a point to a segment
+static float segment_distance(const xyz_pos_t &p, const bench_segment_t &s) {
+  const xyz_pos_t d = s.end - s.start, v = p - s.start;
+  const float len_sq = sq(d.x) + sq(d.y) + sq(d.z),
+              t = len_sq > 0 ? constrain((v.x * d.x + v.y * d.y + v.z * d.z) / len_sq, 0.0f, 1.0f) : 0.0f;
+  return SQRT(sq(v.x - t * d.x) + sq(v.y - t * d.y) + sq(v.z - t * d.z));
+}
+
+/**
+ * Follow the stepper along the planned segments. Step past a segment once
+ * the next one is at least as close, so a path that doubles back on itself
+ * isn't taken for the one being stepped.
+ */
+void Benchmark::sample_deviation() {
+  if (seg_tail == seg_head) return;
+  xyz_pos_t p;
+  LOOP_L_N(a, XYZ) p[a] = stepper.position(AxisEnum(a)) * planner.mm_per_step[a];
+  float d = segment_distance(p, segments[seg_tail]);
+  for (uint16_t n = SEG_MOD(seg_tail + 1); n != seg_head; n = SEG_MOD(n + 1)) {
+    const float dn = segment_distance(p, segments[n]);
+    if (dn > d) break;
+    d = dn;
+    seg_tail = n;
+  }
+  NOLESS(dev_max, d);
+  dev_sum_sq += sq(d);
+  dev_count++;
+}
+
+#ifdef TEMP_WINDOW
+  #define BENCH_HOTEND_WINDOW TEMP_WINDOW
+#else
+  #define BENCH_HOTEND_WINDOW 1
+#endif
+#ifdef TEMP_BED_WINDOW
+  #define BENCH_BED_WINDOW TEMP_BED_WINDOW
+#else
+  #define BENCH_BED_WINDOW 1
+#endif
+
+// Follow each heater from the moment its target changes
+void Benchmark::sample_thermal() {
+  const uint64_t now = Clock::nanos();
+  LOOP_L_N(h, COUNT(heaters)) {
+    const celsius_t target = h ? TERN0(HAS_HEATED_BED, thermalManager.degTargetBed())
+                               : TERN0(HAS_HOTEND, thermalManager.degTargetHotend(0));
+    const float t = heaters[h]->temperature;
+    thermal_step_t *s = step_now[h];
+    if (!s || s->target != target) {
+      s = step_now[h] = (target && step_count < COUNT(thermal_steps)) ? &thermal_steps[step_count++] : nullptr;
+      if (!s) continue;
+      *s = { h, celsius_t(LROUND(t)), target, now, 0, 0, 0, 0, t, t };
+    }
+
+    const float err = t - s->target, window = h ? BENCH_BED_WINDOW : BENCH_HOTEND_WINDOW;
+    const bool heating = s->target > s->from;
+    if (!s->reached_ns && (heating ? err >= 0 : err <= 0)) s->reached_ns = now;
+    if (s->reached_ns) {
+      NOLESS(s->overshoot, heating ? err : -err);
+      NOLESS(s->dip, heating ? -err : err);
+    }
+    if (ABS(err) > window)
+      s->settled_ns = 0;
+    else if (!s->settled_ns) {
+      s->settled_ns = now;
+      s->lo = s->hi = t;
+    }
+    if (s->settled_ns) { NOMORE(s->lo, t); NOLESS(s->hi, t); }
+  }
+}
+
+void Benchmark::idle() {
+  usb_serial.drainTX();
+
+  Timer *next = nullptr;
+  for (Timer &t : timers)
+    if (t.enabled() && (!next || t.due() < next->due())) next = &t;
+  if (!next) { Clock::advance(1000); return; }
+
+  // Jump ahead to the timer. Nothing to step while G-code is waiting is a stall.
+  const uint64_t due = next->due(), now = Clock::nanos();
+  if (due > now) {
+    const bool stall = blocks && !planner.busy() && input_pending();
+    if (stall) {
+      if (!stalled) underruns++;
+      stall_ns += due - now;
+    }
+    stalled = stall;
+    Clock::advanceTo(due);
+  }
+
+  if (next == &timers[MF_TIMER_STEP]) {
+    const uint64_t t0 = Clock::hostNanos();
+    next->fire();
+    isr_host_ns += Clock::hostNanos() - t0;
+    isr_count++;
+    if (planner.has_blocks_queued()) sample_deviation();
+  }
+  else {
+    next->fire();
+
+    // Fan and filament losses since the last update
+    const uint64_t now = Clock::nanos();
+    const float dt = (now - last_load_ns) * 1e-9f;
+    heaters[0]->fan = TERN0(HAS_FAN, thermalManager.fan_speed[0] / 255.0f);
+    heaters[0]->filament_mm_s = dt > 0 ? _MAX(0, (axes[3]->position - last_e) * planner.mm_per_step[E_AXIS] / dt) : 0;
+    last_e = axes[3]->position;
+    last_load_ns = now;
+
+    for (Heater *h : heaters) h->update();
+    sample_thermal();
+    TERN_(HAS_BAFSD, bafs->update());
+  }
+}
+
+static double per_sec(const uint64_t n, const double s) { return s > 0 ? n / s : 0; }
+
+static void print_secs(const uint64_t from_ns, const uint64_t to_ns) {
+  if (to_ns) printf("  %7.1f s", (to_ns - from_ns) * 1e-9);
+  else printf("  %7s  ", "-");
+}
+
+void Benchmark::report(const char * const path) {
+  const double host_s = (Clock::hostNanos() - host_start) * 1e-9,
+               virtual_s = (Clock::nanos() - virtual_start) * 1e-9;
+  uint64_t steps = 0;
+  for (LinearAxis *a : axes) steps += a->steps;
+
+  printf("Benchmark: %s\n", path ?: "stdin");
+  printf("  Commands     %10u  %12.0f/s\n", commands, per_sec(commands, host_s));
+  printf("  Blocks       %10u  %12.0f/s\n", blocks, per_sec(blocks, host_s));
+  printf("  Step events  %10llu  %12.0f/s\n", (unsigned long long)steps, per_sec(steps, host_s));
+  printf("  Stepper ISR  %10u  %12.0f ns avg\n", isr_count, isr_count ? double(isr_host_ns) / isr_count : 0.0);
+  printf("  Time         %10.3f s virtual, %.3f s host\n", virtual_s, host_s);
+  printf("  Stall        %10.3f ms in %u underruns\n", stall_ns * 1e-6, underruns);
+  printf("  Deviation    %10.4f mm max, %.4f mm rms\n", dev_max, dev_count ? SQRT(dev_sum_sq / dev_count) : 0.0);
+
+  if (!step_count) return;
+  printf("  Heater   Target (C)       Rise     Settle  Overshoot        Dip     Ripple\n");
+  LOOP_L_N(i, step_count) {
+    const thermal_step_t &s = thermal_steps[i];
+    printf("  %-6s  %4d -> %4d", s.heater ? "Bed" : "Hotend", s.from, s.target);
+    print_secs(s.start_ns, s.reached_ns);
+    print_secs(s.start_ns, s.settled_ns);
+    printf("  %7.2f C  %7.2f C", s.overshoot, s.dip);
+    if (s.settled_ns) printf("  %7.2f C\n", s.hi - s.lo); else printf("  %7s\n", "-");
+  }
+}
+
+bool Benchmark::set_model(const char * const setting) {
+  static const struct { const char *name; float HeaterModel::*field; } fields[] = {
+    { "power", &HeaterModel::power }, { "capacity", &HeaterModel::capacity },
+    { "ambient_loss", &HeaterModel::ambient_loss }, { "fan_loss", &HeaterModel::fan_loss },
+    { "filament_heat", &HeaterModel::filament_heat }, { "sensor_lag", &HeaterModel::sensor_lag },
+    { "heater_lag", &HeaterModel::heater_lag }, { "ambient", &HeaterModel::ambient }
+  };
+  HeaterModel * const m = !strncmp(setting, "hotend.", 7) ? &models[0] : !strncmp(setting, "bed.", 4) ? &models[1] : nullptr;
+  if (!m) return false;
+  const char * const key = strchr(setting, '.') + 1, * const eq = strchr(key, '=');
+  if (!eq) return false;
+  for (auto &f : fields)
+    if (strlen(f.name) == size_t(eq - key) && !strncmp(key, f.name, eq - key)) {
+      m->*f.field = atof(eq + 1);
+      return m->capacity > 0 && m->sensor_lag > 0;
+    }
+  return false;
+}
+
+int Benchmark::run(const char * const path) {
+  file = path ? fopen(path, "r") : stdin;
+  if (!file) { perror(path); return 1; }
+
+  Heater hotend(HEATER_0_PIN, TEMP_0_PIN, models[0], HEATER_TABLE(0)),
+         bed(HEATER_BED_PIN, TEMP_BED_PIN, models[1], HEATER_TABLE(BED));
+  LinearAxis x_axis(X_ENABLE_PIN, X_DIR_PIN, X_STEP_PIN, X_MIN_PIN, X_MAX_PIN),
+             y_axis(Y_ENABLE_PIN, Y_DIR_PIN, Y_STEP_PIN, Y_MIN_PIN, Y_MAX_PIN),
+             z_axis(Z_ENABLE_PIN, Z_DIR_PIN, Z_STEP_PIN, Z_MIN_PIN, Z_MAX_PIN),
+             extruder0(E0_ENABLE_PIN, E0_DIR_PIN, E0_STEP_PIN, P_NC, P_NC);
+  heaters[0] = &hotend; heaters[1] = &bed;
+  axes[0] = &x_axis; axes[1] = &y_axis; axes[2] = &z_axis; axes[3] = &extruder0;
+  #if HAS_BAFSD
+    BAFSDevice bafs_device(BAFSD_SERIAL, extruder0);
+    bafs = &bafs_device;
+  #endif
+
+  Clock::setFrequency(F_CPU);
+  HAL_timer_init();
+  setup();
+
+  host_start = Clock::hostNanos();
+  virtual_start = last_load_ns = Clock::nanos();
+  for (;;) {
+    feed();
+    if (!input_pending() && !planner.busy()) break;
+    loop();
+  }
+  usb_serial.drainTX();
+
+  report(path);
+  if (file != stdin) fclose(file);
+  return 0;
+}
+
+#endif // LINUX_BENCHMARK
+#endif // __PLAT_LINUX__
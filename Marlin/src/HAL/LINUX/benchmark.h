@@ -0,0 +1,69 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2023 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * benchmark.h - Stream a G-code file through the firmware in virtual time
+ *
+ * Build with -DLINUX_BENCHMARK and run `marlin file.gcode` (or pipe the file to stdin).
+ * There are no threads and no real timers. Whenever the firmware calls idle() the clock
+ * jumps to the next stepper or temperature timer and the benchmark runs its ISR, so the
+ * run takes only as long as the firmware's own work and the motion is the same on
+ * every host. The summary at the end of the file has:
+ *
+ *  - Commands, blocks and step events, with their rate in host time
+ *  - The host time spent in the stepper ISR
+ *  - Planner stall: virtual time with nothing to step while G-code was still waiting
+ *  - Deviation of the stepper position from the planned segments, sampled after each ISR
+ *  - The response of each heater to each new target: rise and settle time, overshoot, the
+ *    worst dip back below target and the ripple once settled, all from the block
+ *    temperature of the heater model
+ *
+ * The heaters are HeaterModel plants driven by the firmware's own PID, MPC or bang-bang
+ * output, with fan and filament losses from the part fan and extruder. Change the model
+ * with settings ahead of the file, e.g. `marlin hotend.power=50 bed.capacity=400 file.gcode`.
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+class Benchmark {
+public:
+  static int run(const char * const path);
+
+  // Called by hal.idletask(). Runs the next timer that's due.
+  static void idle();
+
+  // Called by the planner for each queued move, in steps
+  static void block_planned(const xyze_long_t &start, const xyze_long_t &end);
+
+  // Change a heater model parameter with "hotend.<name>=<value>" or "bed.<name>=<value>"
+  static bool set_model(const char * const setting);
+
+private:
+  static void feed();
+  static bool input_pending();
+  static void sample_deviation();
+  static void sample_thermal();
+  static void report(const char * const path);
+};
+
+extern Benchmark bench;
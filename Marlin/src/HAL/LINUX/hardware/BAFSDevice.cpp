@@ -0,0 +1,281 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#ifdef __PLAT_LINUX__
+
+#include "../../../inc/MarlinConfig.h"
+
+#if HAS_BAFSD
+
+#include <stdlib.h>
+#include <string.h>
+#include "Clock.h"
+#include "BAFSDevice.h"
+#include "../../../feature/mmu/bafsd.h"
+#include "../../../libs/crc16.h"
+
+#define FRAME_SYNC 0xBA
+#define NO_PORT 0xFF
+#define PUSH_MS 3000  // The unit keeps pushing this long around the end of a switch
+#define LATE_MS 1000  // Delay of a late reply
+
+BAFSDevice::BAFSDevice(HalSerial &serial, LinearAxis &extruder) : serial(serial), extruder(extruder) {
+  constexpr float spm[] = DEFAULT_AXIS_STEPS_PER_UNIT;
+  steps_per_mm = spm[E_AXIS];
+  last_steps = extruder.position;
+
+  // Nothing loaded yet
+  port = staged = NO_PORT;
+  tip = -(BAFSD_SENSOR_TO_GEAR_DISTANCE);
+  gripped = grip_miss = false;
+  push_from = push_until = grip_at = line_due = 0;
+  edges = sensor = framed = false;
+  in_frame = false;
+  line_len = frame_len = 0;
+
+  read_config();
+}
+
+void BAFSDevice::read_config() {
+  switch_base_ms = 1500; switch_step_ms = 1000; staged_ms = 800;
+  fault_grip = fault_timeout = fault_garbage = fault_late = 0;
+
+  const char *env = getenv("BAFS_SIM_SWITCH_MS");
+  if (env) sscanf(env, "%u,%u", &switch_base_ms, &switch_step_ms);
+  env = getenv("BAFS_SIM_STAGED_MS");
+  if (env) staged_ms = atoi(env);
+  ascii_only = getenv("BAFS_SIM_ASCII") != nullptr;
+
+  empty = 0;
+  for (env = getenv("BAFS_SIM_EMPTY"); env && *env; env = strchr(env, ',') ? strchr(env, ',') + 1 : nullptr)
+    if (atoi(env) < 8) SBI(empty, atoi(env));
+
+  env = getenv("BAFS_SIM_FAULTS");
+  while (env && *env) {
+    const char *val = strchr(env, '=');
+    if (!val) break;
+    const uint8_t odds = atoi(val + 1);
+    if (!strncmp(env, "grip", 4)) fault_grip = odds;
+    else if (!strncmp(env, "timeout", 7)) fault_timeout = odds;
+    else if (!strncmp(env, "garbage", 7)) fault_garbage = odds;
+    else if (!strncmp(env, "late", 4)) fault_late = odds;
+    env = strchr(val, ',');
+    if (env) env++;
+  }
+
+  printf("BAFS sim: switch %ums + %ums/port, staged %ums, %s, faults grip %u%% timeout %u%% garbage %u%% late %u%%, empty 0x%02X\n",
+    switch_base_ms, switch_step_ms, staged_ms, ascii_only ? "ASCII only" : "framing",
+    fault_grip, fault_timeout, fault_garbage, fault_late, empty);
+}
+
+bool BAFSDevice::roll(const uint8_t percent) {
+  return percent && uint8_t(rand() % 100) < percent;
+}
+
+void BAFSDevice::update() {
+  const uint64_t now = Clock::millis();
+
+  for (int c; (c = serial.transmit_buffer.read()) >= 0;) rx_byte(c);
+
+  move_filament(now);
+
+  for (auto r = replies.begin(); r != replies.end();) {
+    if (now >= r->due) {
+      if (roll(fault_garbage)) send_garbage();
+      send(r->frame, r->seq, r->op | BAFSD_OP_REPLY, r->status);
+      r = replies.erase(r);
+    }
+    else
+      ++r;
+  }
+}
+
+/**
+ * Move the tip with the extruder while the gear holds the filament.
+ * Forward E while the unit pushes grips a fed filament.
+ */
+void BAFSDevice::move_filament(const uint64_t now) {
+  const int32_t steps = extruder.position;
+  const float de = (steps - last_steps) / steps_per_mm * TERN(INVERT_E0_DIR, -1, 1);
+  last_steps = steps;
+
+  constexpr float gear = -(BAFSD_SENSOR_TO_GEAR_DISTANCE);
+  if (gripped) {
+    tip += de;
+    if (tip < gear) { gripped = false; tip = gear; } // Pulled out of the gear
+  }
+  else if (de > 0 && port != NO_PORT && !grip_miss && now >= push_from && now < push_until) {
+    gripped = true;
+    tip += de;
+  }
+  else if (grip_at && now >= grip_at) {
+    gripped = true;
+    grip_at = 0;
+  }
+
+  const bool s = tip >= 0;
+  if (s != sensor) {
+    sensor = s;
+    if (edges) send(framed, 0, BAFSD_OP_EDGE, s);
+  }
+}
+
+void BAFSDevice::rx_byte(const uint8_t c) {
+  if (in_frame) {
+    frame[frame_len++] = c;
+    if (frame[0] > 4) in_frame = false;  // Bad length, wait for the next SYNC
+    else if (frame_len == frame[0] + 5) { in_frame = false; rx_frame(); }
+    return;
+  }
+
+  if (c == FRAME_SYNC && !line_len && !ascii_only) {
+    in_frame = true;
+    frame_len = 0;
+    return;
+  }
+
+  if (c == '\n' || c == '\r') {
+    line[line_len] = '\0';
+    if (line_len) rx_line();
+    line_len = 0;
+  }
+  else if (line_len < sizeof(line) - 1)
+    line[line_len++] = c;
+}
+
+void BAFSDevice::rx_frame() {
+  const uint8_t len = frame[0];
+  uint16_t crc = 0;
+  crc16(&crc, frame, 3 + len);
+  if (crc != ((frame[3 + len] << 8) | frame[4 + len])) return;
+
+  uint32_t arg = 0;
+  for (uint8_t i = len; i--;) arg = (arg << 8) | frame[3 + i];
+  handle(true, frame[1], frame[2], arg);
+}
+
+void BAFSDevice::rx_line() {
+  unsigned arg = 0;
+  if (sscanf(line, "T%u", &arg) == 1)             handle(false, 0, BAFSD_OP_SELECT, arg);
+  else if (!strcmp(line, "M412 E1"))              handle(false, 0, BAFSD_OP_EVENTS, 0);
+  else if (!strcmp(line, "M412"))                 handle(false, 0, BAFSD_OP_SENSOR, 0);
+  else if (sscanf(line, "C%u", &arg) == 1)        handle(false, 0, BAFSD_OP_FEED, arg);
+  else if (sscanf(line, "M240 D%u", &arg) == 1)   handle(false, 0, BAFSD_OP_CAMERA, arg);
+  else if (!strcmp(line, "M709"))                 handle(false, 0, BAFSD_OP_RESET, 0);
+  else if (sscanf(line, "P%u", &arg) == 1)        handle(false, 0, BAFSD_OP_STAGE, arg);
+  // Anything else is dropped without a reply
+}
+
+void BAFSDevice::handle(const bool frame, const uint8_t seq, const uint8_t op, const uint32_t arg) {
+  const uint64_t now = Clock::millis();
+  switch (op) {
+    case BAFSD_OP_HELLO:
+      framed = true;
+      reply(frame, seq, op, true, now);
+      break;
+
+    case BAFSD_OP_SELECT: {
+      if (arg >= EXTRUDERS) { reply(frame, seq, op, false, now); break; }
+      if (arg == port) { reply(frame, seq, op, true, now + 50); break; }
+      // The old filament has to be out of the gear
+      if (gripped && port != NO_PORT) { reply(frame, seq, op, false, now + 500); break; }
+
+      const uint32_t ms = arg == staged ? staged_ms : switch_base_ms + switch_step_ms * (port == NO_PORT ? 0 : abs(int(port) - int(arg)));
+      if (port == NO_PORT) {
+        // The first filament is loaded all the way, as the user would by hand
+        tip = 0; gripped = true;
+      }
+      else {
+        tip = -(BAFSD_SENSOR_TO_GEAR_DISTANCE);
+        gripped = false;
+        grip_miss = roll(fault_grip) || TEST(empty, arg);
+        grip_at = 0;
+      }
+      port = arg;
+      staged = NO_PORT;
+      push_from = now + ms - _MIN(ms, uint32_t(PUSH_MS));
+      push_until = now + ms + PUSH_MS;
+      reply(frame, seq, op, true, now + ms);
+    } break;
+
+    case BAFSD_OP_SENSOR:
+      reply(frame, seq, op, sensor, now + 5);
+      break;
+
+    case BAFSD_OP_FEED:
+      if (port != NO_PORT && !gripped && !TEST(empty, port)) grip_at = now + BAFSD_SMALL_FEED_DURATION;
+      reply(frame, seq, op, true, now + BAFSD_SMALL_FEED_DURATION);
+      break;
+
+    case BAFSD_OP_STAGE: {
+      const bool ok = arg < EXTRUDERS && arg != port;
+      if (ok) staged = arg;
+      reply(frame, seq, op, ok, now + 5);
+    } break;
+
+    case BAFSD_OP_EVENTS:
+      edges = true;
+      reply(frame, seq, op, true, now + 5);
+      break;
+
+    case BAFSD_OP_RESET:
+      edges = false;
+      staged = NO_PORT;
+      reply(frame, seq, op, true, now + 100);
+      break;
+
+    case BAFSD_OP_CAMERA:
+      reply(frame, seq, op, true, now + 5);
+      break;
+
+    default:
+      reply(frame, seq, op, false, now);
+      break;
+  }
+}
+
+void BAFSDevice::reply(const bool frame, const uint8_t seq, const uint8_t op, const bool ok, const uint64_t due) {
+  if (roll(fault_timeout)) return;
+  uint64_t at = due + (roll(fault_late) ? LATE_MS : 0);
+  if (!frame) at = line_due = _MAX(at, line_due);
+  replies.push_back({ at, frame, seq, op, ok });
+}
+
+void BAFSDevice::send(const bool frame, const uint8_t seq, const uint8_t op, const uint8_t value) {
+  if (frame) {
+    uint8_t out[7] = { FRAME_SYNC, 1, seq, op, value };
+    uint16_t crc = 0;
+    crc16(&crc, out + 1, 4);
+    out[5] = crc >> 8;
+    out[6] = crc & 0xFF;
+    for (const uint8_t c : out) serial.receive_buffer.write(c);
+    return;
+  }
+  const char *msg = op == BAFSD_OP_EDGE ? (value ? "F1\n" : "F0\n") : (value ? "ok\n" : "no\n");
+  while (*msg) serial.receive_buffer.write(*msg++);
+}
+
+void BAFSDevice::send_garbage() {
+  for (uint8_t n = 1 + rand() % 8; n--;) serial.receive_buffer.write(rand() & 0xFF);
+}
+
+#endif // HAS_BAFSD
+#endif // __PLAT_LINUX__
@@ -0,0 +1,98 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <vector>
+#include "LinearAxis.h"
+#include "../include/serial.h"
+
+/**
+ * Software BAFS unit on the far end of BAFSD_SERIAL.
+ * Speaks the ASCII and framed protocols of feature/mmu/bafsd-serial-protocol.md.
+ *
+ * The tip of the loaded filament is tracked in mm from the filament sensor,
+ * with the extruder gear BAFSD_SENSOR_TO_GEAR_DISTANCE before it. Once the
+ * gear has the filament the tip follows the simulated E axis. A new filament
+ * is fed up to the gear and only gets gripped if E turns forward while the
+ * unit is still pushing, which is what the grip assist move is for.
+ *
+ * Set in the environment before starting the simulator:
+ *  BAFS_SIM_SWITCH_MS  Switch time as "base,per port of distance"   (default 1500,1000)
+ *  BAFS_SIM_STAGED_MS  Switch time to a pre-staged port             (default 800)
+ *  BAFS_SIM_ASCII      Act like an older firmware without framing
+ *  BAFS_SIM_EMPTY      Ports with an empty spool, e.g. "0,2". They never load.
+ *  BAFS_SIM_FAULTS     Fault odds in percent, e.g. "grip=10,timeout=5,garbage=2"
+ *                        grip     The new filament is not gripped until a small feed
+ *                        timeout  A reply is never sent
+ *                        garbage  Random bytes are sent before a reply
+ *                        late     A reply comes 1s late. Framed replies to later requests
+ *                                 overtake it, ASCII replies wait behind it.
+ */
+class BAFSDevice {
+public:
+  BAFSDevice(HalSerial &serial, LinearAxis &extruder);
+  void update();
+
+private:
+  struct Reply {
+    uint64_t due;
+    bool frame;
+    uint8_t seq, op, status;
+  };
+
+  HalSerial &serial;
+  LinearAxis &extruder;
+  float steps_per_mm;
+  int32_t last_steps;
+
+  uint8_t port, staged;
+  float tip;                  // Filament tip, mm past the sensor
+  bool gripped, grip_miss;
+  uint64_t push_from, push_until,
+           grip_at;           // A small feed forces the filament into the gear
+  bool edges, sensor, framed;
+
+  uint32_t switch_base_ms, switch_step_ms, staged_ms;
+  bool ascii_only;
+  uint8_t fault_grip, fault_timeout, fault_garbage, fault_late;
+  uint8_t empty;              // Bit per port with an empty spool
+
+  std::vector<Reply> replies;
+  uint64_t line_due;          // An ASCII unit answers its lines in order
+
+  char line[32];
+  uint8_t line_len;
+  bool in_frame;
+  uint8_t frame[9], frame_len;  // LEN SEQ OP PAYLOAD[4] CRC_HI CRC_LO
+
+  void read_config();
+  static bool roll(const uint8_t percent);
+
+  void rx_byte(const uint8_t c);
+  void rx_line();
+  void rx_frame();
+  void handle(const bool frame, const uint8_t seq, const uint8_t op, const uint32_t arg);
+  void reply(const bool frame, const uint8_t seq, const uint8_t op, const bool ok, const uint64_t due);
+  void send(const bool frame, const uint8_t seq, const uint8_t op, const uint8_t value);
+  void send_garbage();
+  void move_filament(const uint64_t now);
+};
@@ -45,10 +45,25 @@ public:
 
   // Time Acceleration compensated
   static uint64_t nanos() {
-    auto now = std::chrono::high_resolution_clock::now().time_since_epoch();
-    return (now.count() - Clock::startup.count()) * Clock::time_multiplier;
+    #ifdef LINUX_BENCHMARK
+      return Clock::virtual_ns;
+    #else
+      auto now = std::chrono::high_resolution_clock::now().time_since_epoch();
+      return (now.count() - Clock::startup.count()) * Clock::time_multiplier;
+    #endif
   }
 
+  #ifdef LINUX_BENCHMARK
+    // Virtual time only moves when the benchmark runs a timer or something waits
+    static void advance(uint64_t ns) { Clock::virtual_ns += ns; }
+    static void advanceTo(uint64_t ns) { if (ns > Clock::virtual_ns) Clock::virtual_ns = ns; }
+
+    // The host clock, for timing the firmware itself
+    static uint64_t hostNanos() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+  #endif
+
   static uint64_t micros() {
     return Clock::nanos() / 1000;
   }
@@ -62,19 +77,35 @@ public:
   }
 
   static void delayCycles(uint64_t cycles) {
-    std::this_thread::sleep_for(std::chrono::nanoseconds( (1000000000L / frequency) * cycles) / Clock::time_multiplier );
+    #ifdef LINUX_BENCHMARK
+      Clock::advance((1000000000L / frequency) * cycles);
+    #else
+      std::this_thread::sleep_for(std::chrono::nanoseconds( (1000000000L / frequency) * cycles) / Clock::time_multiplier );
+    #endif
   }
 
   static void delayMicros(uint64_t micros) {
-    std::this_thread::sleep_for(std::chrono::microseconds( micros ) / Clock::time_multiplier);
+    #ifdef LINUX_BENCHMARK
+      Clock::advance(micros * 1000);
+    #else
+      std::this_thread::sleep_for(std::chrono::microseconds( micros ) / Clock::time_multiplier);
+    #endif
   }
 
   static void delayMillis(uint64_t millis) {
-    std::this_thread::sleep_for(std::chrono::milliseconds( millis ) / Clock::time_multiplier);
+    #ifdef LINUX_BENCHMARK
+      Clock::advance(millis * 1000000);
+    #else
+      std::this_thread::sleep_for(std::chrono::milliseconds( millis ) / Clock::time_multiplier);
+    #endif
   }
 
   static void delaySeconds(double secs) {
-    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(secs * 1000) / Clock::time_multiplier);
+    #ifdef LINUX_BENCHMARK
+      Clock::advance(uint64_t(secs * 1000000000));
+    #else
+      std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(secs * 1000) / Clock::time_multiplier);
+    #endif
   }
 
   // Will reduce timer resolution increasing likelihood of overflows
@@ -86,4 +117,7 @@ private:
   static std::chrono::nanoseconds startup;
   static uint32_t frequency;
   static double time_multiplier;
+  #ifdef LINUX_BENCHMARK
+    static uint64_t virtual_ns;
+  #endif
 };
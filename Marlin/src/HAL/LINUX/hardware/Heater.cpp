@@ -23,34 +23,58 @@
 
 #include "Clock.h"
 #include <stdio.h>
+#include <math.h>
 #include "../../../inc/MarlinConfig.h"
 
 #include "Heater.h"
 
-Heater::Heater(pin_t heater, pin_t adc) {
-  heater_state = 0;
-  room_temp_raw = 150;
-  last = Clock::micros();
-  heater_pin = heater;
-  adc_pin = adc;
-  heat = 0.0;
+constexpr HeaterModel Heater::hotend_model, Heater::bed_model;
+
+Heater::Heater(pin_t heater, pin_t adc, const HeaterModel &model, const temp_entry_t *table, const uint8_t table_len)
+  : heater_pin(heater), adc_pin(adc), model(model), fan(0), filament_mm_s(0),
+    temperature(model.ambient), sensor(model.ambient), table(table), table_len(table_len), duty(0), heat(0), dither(1)
+{
+  last = Clock::nanos();
+  Gpio::pin_map[analogInputToDigitalPin(adc_pin)].value = uint16_t(adc_for(sensor)) << 2;
 }
 
 Heater::~Heater() {
 }
 
-void Heater::update() {
-  // crude pwm read and cruder heat simulation
-  auto now = Clock::micros();
-  double delta = (now - last);
-  if (delta > 1000 ) {
-    heater_state = pwmcap.update(0xFFFF * Gpio::pin_map[heater_pin].value);
-    last = now;
-    heat += (heater_state - heat) * (delta / 1000000000.0);
-
-    NOLESS(heat, room_temp_raw);
-    Gpio::pin_map[analogInputToDigitalPin(adc_pin)].value = 0xFFFF - (uint16_t)heat;
+// The 10-bit ADC reading for a temperature, from the firmware's own table
+float Heater::adc_for(const float celsius) const {
+  if (!table || table_len < 2) return 0;
+  for (uint8_t i = 1; i < table_len; i++) {
+    const float c0 = table[i - 1].celsius, c1 = table[i].celsius;
+    if (WITHIN(celsius, _MIN(c0, c1), _MAX(c0, c1)) && c0 != c1) {
+      const float v0 = table[i - 1].value, v1 = table[i].value;
+      return (v0 + (celsius - c0) * (v1 - v0) / (c1 - c0)) / (OVERSAMPLENR) / (THERMISTOR_TABLE_SCALE);
+    }
   }
+  // Off the table, so take the end nearest in temperature
+  const bool first = ABS(celsius - table[0].celsius) < ABS(celsius - table[table_len - 1].celsius);
+  return float(first ? table[0].value : table[table_len - 1].value) / (OVERSAMPLENR) / (THERMISTOR_TABLE_SCALE);
+}
+
+void Heater::update() {
+  const uint64_t now = Clock::nanos();
+  const float dt = (now - last) * 1e-9f;
+  if (dt <= 0) return;
+  last = now;
+
+  // Heat in from the duty held since the last update, through the heater lag, then losses to the room, fan and filament
+  heat += (model.power * duty - heat) * (model.heater_lag > 0 ? _MIN(dt / model.heater_lag, 1.0f) : 1.0f);
+  const float loss = model.ambient_loss + model.fan_loss * fan + model.filament_heat * filament_mm_s;
+  temperature += (heat - loss * (temperature - model.ambient)) * dt / model.capacity;
+  sensor += (temperature - sensor) * _MIN(dt / model.sensor_lag, 1.0f);
+
+  const uint16_t v = Gpio::pin_map[heater_pin].value;
+  duty = v > 1 ? v / 255.0f : v;
+
+  // Dither the reading so oversampling sees between ADC counts, as on real hardware
+  dither = dither * 1103515245UL + 12345UL;
+  const float adc = adc_for(sensor) + float(dither >> 16 & 0xFFFF) / 65536.0f;
+  Gpio::pin_map[analogInputToDigitalPin(adc_pin)].value = uint16_t(constrain(adc, 0, 1023)) << 2;
 }
 
 void Heater::interrupt(GpioEvent ev) {
@@ -22,26 +22,52 @@
 #pragma once
 
 #include "Gpio.h"
+#include "../../../module/thermistor/thermistors.h"
 
-struct LowpassFilter {
-  uint64_t data_delay = 0;
-  uint16_t update(uint16_t value) {
-    data_delay += value - (data_delay >> 6);
-    return uint16_t(data_delay >> 6);
-  }
+/**
+ * A lumped thermal model of a heater, its block and its sensor.
+ * The block loses heat to the room, to the part fan, and to the filament
+ * pushed through it. The heat reaching the block and the sensor reading
+ * each follow with a first-order lag.
+ */
+struct HeaterModel {
+  float power,          // (W) Heater power at full duty
+        capacity,       // (J/K) Heat capacity of the block
+        ambient_loss,   // (W/K) Loss to still air
+        fan_loss,       // (W/K) Extra loss with the fan at full speed
+        filament_heat,  // (J/K/mm) Heat taken by each mm of filament
+        sensor_lag,     // (s) Time constant of the sensor
+        heater_lag,     // (s) Time constant of the heater's own heat-up, 0 for none
+        ambient;        // (°C) Room temperature
 };
 
+// The thermistor table that turns the sensor temperature into an ADC value
+#define HEATER_TABLE(N) TERN(TEMP_SENSOR_##N##_IS_THERMISTOR, TEMPTABLE_##N, nullptr), TERN0(TEMP_SENSOR_##N##_IS_THERMISTOR, TEMPTABLE_##N##_LEN)
+
 class Heater: public Peripheral {
 public:
-  Heater(pin_t heater, pin_t adc);
+  static constexpr HeaterModel hotend_model = { 40.0f, 16.0f, 0.08f, 0.06f, 5.6e-3f, 1.5f, 0.0f, 25.0f },
+                               bed_model    = { 220.0f, 500.0f, 1.6f, 0.0f, 0.0f, 8.0f, 0.0f, 25.0f };
+
+  Heater(pin_t heater, pin_t adc, const HeaterModel &model, const temp_entry_t *table, const uint8_t table_len);
   virtual ~Heater();
   void interrupt(GpioEvent ev);
   void update();
 
   pin_t heater_pin, adc_pin;
-  uint16_t room_temp_raw;
-  uint16_t heater_state;
-  LowpassFilter pwmcap;
-  double heat;
+  HeaterModel model;
+  float fan,            // Part fan speed, 0-1
+        filament_mm_s;  // Filament fed into the block
+  float temperature,    // (°C) The block
+        sensor;         // (°C) What the sensor sees
+
+private:
+  float adc_for(const float celsius) const;
+
+  const temp_entry_t *table;
+  uint8_t table_len;
+  float duty,           // Heater output since the last update
+        heat;           // (W) Heat going into the block
+  uint32_t dither;
   uint64_t last;
 };
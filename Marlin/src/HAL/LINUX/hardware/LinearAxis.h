@@ -41,5 +41,6 @@ public:
   int32_t min_position;
   int32_t max_position;
   uint64_t last_update;
+  uint64_t steps;
 
 };
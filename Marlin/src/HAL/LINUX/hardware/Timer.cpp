@@ -47,6 +47,10 @@ void Timer::init(uint32_t sig_id, uint32_t sim_freq, callback_fn* fn) {
   frequency = sim_freq;
   cbfn = fn;
 
+  #ifdef LINUX_BENCHMARK
+    return; // No signals, the benchmark fires the timers in virtual time
+  #endif
+
   sa.sa_flags = SA_SIGINFO;
   sa.sa_sigaction = Timer::handler;
   sigemptyset(&sa.sa_mask);
@@ -73,21 +77,29 @@ void Timer::start(uint32_t frequency) {
 }
 
 void Timer::enable() {
-  if (sigprocmask(SIG_UNBLOCK, &mask, nullptr) == -1) {
-    return; // todo: handle error
-  }
+  #ifndef LINUX_BENCHMARK // No signals to mask in virtual time
+    if (sigprocmask(SIG_UNBLOCK, &mask, nullptr) == -1) {
+      return; // todo: handle error
+    }
+  #endif
   active = true;
   //printf("timer(%ld) enabled\n", getID());
 }
 
 void Timer::disable() {
-  if (sigprocmask(SIG_SETMASK, &mask, nullptr) == -1) {
-    return; // todo: handle error
-  }
+  #ifndef LINUX_BENCHMARK
+    if (sigprocmask(SIG_SETMASK, &mask, nullptr) == -1) {
+      return; // todo: handle error
+    }
+  #endif
   active = false;
 }
 
 void Timer::setCompare(uint32_t compare) {
+  #ifdef LINUX_BENCHMARK
+    this->compare = compare; // Counted from the last time the timer fired, as on the MCU
+    return;
+  #endif
   uint32_t nsec_offset = 0;
   if (active) {
     nsec_offset = Clock::nanos() - this->start_time; // calculate how long the timer would have been running for
@@ -111,6 +123,9 @@ void Timer::setCompare(uint32_t compare) {
 }
 
 uint32_t Timer::getCount() {
+  #ifdef LINUX_BENCHMARK
+    Clock::advance(Clock::ticksToNanos(1, frequency)); // Each read takes a tick, so the pulse width waits can end
+  #endif
   return Clock::nanosToTicks(Clock::nanos() - this->start_time, frequency);
 }
 
@@ -29,6 +29,9 @@
 #include "hardware/IOLoggerCSV.h"
 #include "hardware/Heater.h"
 #include "hardware/LinearAxis.h"
+#if HAS_BAFSD
+  #include "hardware/BAFSDevice.h"
+#endif
 
 #include <stdio.h>
 #include <stdarg.h>
@@ -36,6 +39,24 @@
 #include <iostream>
 #include <fstream>
 
+#if ENABLED(LINUX_BENCHMARK)
+
+#include "benchmark.h"
+
+int main(int argc, char *argv[]) {
+  const char *path = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (!strchr(argv[i], '=')) path = argv[i];
+    else if (!bench.set_model(argv[i])) {
+      fprintf(stderr, "Unknown heater model setting: %s\n", argv[i]);
+      return 1;
+    }
+  }
+  return bench.run(path);
+}
+
+#else
+
 extern void setup();
 extern void loop();
 
@@ -61,12 +82,15 @@ void read_serial_thread() {
 }
 
 void simulation_loop() {
-  Heater hotend(HEATER_0_PIN, TEMP_0_PIN);
-  Heater bed(HEATER_BED_PIN, TEMP_BED_PIN);
+  Heater hotend(HEATER_0_PIN, TEMP_0_PIN, Heater::hotend_model, HEATER_TABLE(0));
+  Heater bed(HEATER_BED_PIN, TEMP_BED_PIN, Heater::bed_model, HEATER_TABLE(BED));
   LinearAxis x_axis(X_ENABLE_PIN, X_DIR_PIN, X_STEP_PIN, X_MIN_PIN, X_MAX_PIN);
   LinearAxis y_axis(Y_ENABLE_PIN, Y_DIR_PIN, Y_STEP_PIN, Y_MIN_PIN, Y_MAX_PIN);
   LinearAxis z_axis(Z_ENABLE_PIN, Z_DIR_PIN, Z_STEP_PIN, Z_MIN_PIN, Z_MAX_PIN);
   LinearAxis extruder0(E0_ENABLE_PIN, E0_DIR_PIN, E0_STEP_PIN, P_NC, P_NC);
+  #if HAS_BAFSD
+    BAFSDevice bafs(BAFSD_SERIAL, extruder0);
+  #endif
 
   #ifdef GPIO_LOGGING
     IOLoggerCSV logger("all_gpio_log.csv");
@@ -87,6 +111,7 @@ void simulation_loop() {
     y_axis.update();
     z_axis.update();
     extruder0.update();
+    TERN_(HAS_BAFSD, bafs.update());
 
     #ifdef GPIO_LOGGING
       if (x_axis.position != x || y_axis.position != y || z_axis.position != z) {
@@ -135,4 +160,6 @@ int main() {
   read_serial.join();
 }
 
+#endif // !LINUX_BENCHMARK
+
 #endif // __PLAT_LINUX__
@@ -224,6 +224,10 @@
   #include "feature/controllerfan.h"
 #endif
 
+#if ENABLED(FT_MOTION)
+  #include "module/ft_motion.h"
+#endif
+
 #if HAS_PRUSA_MMU1
   #include "feature/mmu/mmu.h"
 #endif
@@ -234,6 +238,13 @@
 
 #if HAS_BAFSD
   #include "feature/mmu/bafsd.h"
+  #if ENABLED(BAFSD_PROFILE)
+    #include "feature/mmu/bafsd_stats.h"
+  #endif
+#endif
+
+#if ENABLED(STEPPER_ISR_PROFILE)
+  #include "module/stepper/isr_profile.h"
 #endif
 
 #if ENABLED(PASSWORD_FEATURE)
@@ -794,6 +805,9 @@ void idle(const bool no_stepper_sleep/*=false*/) {
   // Bed Distance Sensor task
   TERN_(BD_SENSOR, bdl.process());
 
+  // Keep the fixed-time motion buffer filled
+  TERN_(FT_MOTION, ftMotion.loop());
+
   // Core Marlin activities
   manage_inactivity(no_stepper_sleep);
 
@@ -871,6 +885,10 @@ void idle(const bool no_stepper_sleep/*=false*/) {
       TERN_(AUTO_REPORT_FANS, fan_check.auto_reporter.tick());
       TERN_(AUTO_REPORT_SD_STATUS, card.auto_reporter.tick());
       TERN_(AUTO_REPORT_POSITION, position_auto_reporter.tick());
+      #if HAS_BAFSD
+        TERN_(BAFSD_PROFILE, bafsd_stats.auto_reporter.tick());
+      #endif
+      TERN_(STEPPER_ISR_PROFILE, isr_profile.auto_reporter.tick());
       TERN_(BUFFER_MONITORING, queue.auto_report_buffer_statistics());
     }
   #endif
@@ -386,7 +386,7 @@ float LevelingBilinear::get_z_correction(const xy_pos_t &raw) {
     // Start and end in the same cell? No split needed.
     if (c1 == c2) {
       current_position = destination;
-      line_to_current_position(scaled_fr_mm_s);
+      planner.coalesce_line(current_position, scaled_fr_mm_s);
       return;
     }
 
@@ -419,7 +419,7 @@ float LevelingBilinear::get_z_correction(const xy_pos_t &raw) {
       // Must already have been split on these border(s)
       // This should be a rare case.
       current_position = destination;
-      line_to_current_position(scaled_fr_mm_s);
+      planner.coalesce_line(current_position, scaled_fr_mm_s);
       return;
     }
 
@@ -72,7 +72,7 @@
       // Start and end in the same cell? No split needed.
       if (scel == ecel) {
         current_position = destination;
-        line_to_current_position(scaled_fr_mm_s);
+        planner.coalesce_line(current_position, scaled_fr_mm_s);
         return;
       }
 
@@ -105,7 +105,7 @@
         // Must already have been split on these border(s)
         // This should be a rare case.
         current_position = destination;
-        line_to_current_position(scaled_fr_mm_s);
+        planner.coalesce_line(current_position, scaled_fr_mm_s);
         return;
       }
 
@@ -78,7 +78,8 @@
           // a calculated (Bi-Linear interpolation) correction.
 
           end.z += UBL_Z_RAISE_WHEN_OFF_MESH;
-          planner.buffer_segment(end, scaled_fr_mm_s, extruder);
+          planner.coalesce_segment(end, scaled_fr_mm_s, extruder);
+          planner.coalesce_flush();
           current_position = destination;
           return;
         }
@@ -96,7 +97,8 @@
       // Undefined parts of the Mesh in z_values[][] are NAN.
       // Replace NAN corrections with 0.0 to prevent NAN propagation.
       if (!isnan(z0)) end.z += z0;
-      planner.buffer_segment(end, scaled_fr_mm_s, extruder);
+      planner.coalesce_segment(end, scaled_fr_mm_s, extruder);
+      planner.coalesce_flush();
       current_position = destination;
       return;
     }
@@ -183,7 +185,7 @@
           }
 
           dest.z += z0;
-          planner.buffer_segment(dest, scaled_fr_mm_s, extruder);
+          planner.coalesce_segment(dest, scaled_fr_mm_s, extruder);
 
         }
         else
@@ -234,7 +236,7 @@
           }
 
           dest.z += z0;
-          if (!planner.buffer_segment(dest, scaled_fr_mm_s, extruder)) break;
+          if (!planner.coalesce_segment(dest, scaled_fr_mm_s, extruder)) break;
 
         }
         else
@@ -289,7 +291,7 @@
         }
 
         dest.z += z0;
-        if (!planner.buffer_segment(dest, scaled_fr_mm_s, extruder)) break;
+        if (!planner.coalesce_segment(dest, scaled_fr_mm_s, extruder)) break;
 
         icell.y += iadd.y;
         cnt.y--;
@@ -316,7 +318,7 @@
         }
 
         dest.z += z0;
-        if (!planner.buffer_segment(dest, scaled_fr_mm_s, extruder)) break;
+        if (!planner.coalesce_segment(dest, scaled_fr_mm_s, extruder)) break;
 
         icell.x += iadd.x;
         cnt.x--;
@@ -392,9 +394,10 @@
     if (!planner.leveling_active || !planner.leveling_active_at_z(destination.z)) {
       while (--segments) {
         raw += diff;
-        planner.buffer_line(raw, scaled_fr_mm_s, active_extruder, hints);
+        planner.coalesce_line(raw, scaled_fr_mm_s, active_extruder, hints);
       }
-      planner.buffer_line(destination, scaled_fr_mm_s, active_extruder, hints);
+      planner.coalesce_line(destination, scaled_fr_mm_s, active_extruder, hints);
+      planner.coalesce_flush();
       return false; // Did not set current from destination
     }
 
@@ -465,11 +468,13 @@
           TERN_(ENABLE_LEVELING_FADE_HEIGHT, * fade_scaling_factor); // apply fade factor to interpolated height
 
         const float oldz = raw.z; raw.z += z_cxcy;
-        planner.buffer_line(raw, scaled_fr_mm_s, active_extruder, hints);
+        planner.coalesce_line(raw, scaled_fr_mm_s, active_extruder, hints);
         raw.z = oldz;
 
-        if (segments == 0)                        // done with last segment
+        if (segments == 0) {                      // done with last segment
+          planner.coalesce_flush();
           return false;                           // didn't set current from destination
+        }
 
         raw += diff;
         cell += diff;
@@ -33,12 +33,33 @@
 #include "../../module/temperature.h"
 #include "../../gcode/gcode.h"
 
+#if ENABLED(BAFSD_FRAMED_LINK)
+  #include "../../libs/crc16.h"
+#endif
+
+#if ENABLED(BAFSD_PROFILE)
+  #include "bafsd_stats.h"
+#endif
+
+#if BOTH(BAFSD_LOOKAHEAD, SDSUPPORT)
+  #include "../../sd/cardreader.h"
+#endif
+
+#if ANY(BAFSD_ODOMETER, BAFSD_FAILOVER)
+  #include "../../lcd/marlinui.h"
+#endif
+
+#if BOTH(BAFSD_ODOMETER, EEPROM_SETTINGS)
+  #include "../../module/settings.h"
+#endif
+
+#if BOTH(BAFSD_FAILOVER, HAS_FILAMENT_SENSOR)
+  #include "../runout.h"
+#endif
+
 #define DEBUG_OUT ENABLED(DEBUG_BAFSD)
 #include "../../core/debug_out.h"
 
-#define BAFSD_SEND(S) tx_str(F(S "\n"))
-#define BAFSD_RECV(S) rx_str(F(S "\n"))
-
 #define NO_PORT 255
 #define BAFSD_BAUD 9600
 
@@ -50,12 +71,56 @@ int BAFSD::timeOut;
 millis_t BAFSD::commandIssueTime;
 bool BAFSD::waitingResponse;
 
+BAFSDPhase BAFSD::phase; // = BAFSD_IDLE
+bool BAFSD::stepping, BAFSD::queried, BAFSD::switchOk, BAFSD::retried;
+uint8_t BAFSD::attempts;
+millis_t BAFSD::holdUntil, BAFSD::phaseExpire;
+
+#if ENABLED(BAFSD_SENSOR_EVENTS)
+  BAFSDEvents BAFSD::events; // = BAFSD_EVENTS_UNKNOWN
+  bool BAFSD::searching, BAFSD::searchFor, BAFSD::edgeSeen;
+  int32_t BAFSD::edgeSteps;
+#endif
+
+#if ENABLED(BAFSD_LOOKAHEAD)
+  uint8_t BAFSD::aheadPort = NO_PORT, BAFSD::stagedPort = NO_PORT, BAFSD::stagePort, BAFSD::stageSeq;
+  bool BAFSD::stagePending;
+  millis_t BAFSD::stageIssueTime, BAFSD::next_scan_ms;
+#endif
+
+#if ENABLED(BAFSD_LEARN_SWITCH_TIME)
+  uint16_t BAFSD::switch_time[EXTRUDERS][EXTRUDERS];
+  bool BAFSD::timeSwitch;
+  millis_t BAFSD::replyTime;
+#endif
+
+#if ENABLED(BAFSD_ODOMETER)
+  float BAFSD::spool_mm[EXTRUDERS], BAFSD::used_mm[EXTRUDERS];
+  BAFSDPhase BAFSD::afterCheck;
+  int32_t BAFSD::fedSteps[EXTRUDERS], BAFSD::countedE;
+#endif
+
+#if ENABLED(BAFSD_FAILOVER)
+  int8_t BAFSD::backup[EXTRUDERS];
+  uint8_t BAFSD::emptyPorts;
+  bool BAFSD::failingOver;
+#endif
+
 char BAFSD::rx_buffer[BAFSD_RX_SIZE], BAFSD::tx_buffer[BAFSD_RX_SIZE];
+uint8_t BAFSD::rx_len;
+CircularQueue<BAFSDEvent, BAFSD_EVENT_QUEUE_SIZE> BAFSD::rx_events;
+uint8_t BAFSD::txSeq, BAFSD::waitSeq;
+CircularQueue<BAFSD::Inflight, BAFSD_MAX_INFLIGHT> BAFSD::sentLines;
+
+#if ENABLED(BAFSD_FRAMED_LINK)
+  BAFSDLink BAFSD::link; // = BAFSD_LINK_UNKNOWN
+  BAFSD::Inflight BAFSD::inflight[BAFSD_MAX_INFLIGHT];
+#endif
 
 BAFSD::BAFSD() {
   port = NO_PORT;
   nextPort = NO_PORT;
-  rx_buffer[0] = '\0';
+  rx_len = 0;
 }
 
 void BAFSD::init() {
@@ -64,7 +129,11 @@ void BAFSD::init() {
 
   safe_delay(10);
   reset();
-  rx_buffer[0] = '\0';
+  rx_len = 0;
+
+  #if BOTH(BAFSD_ODOMETER, EEPROM_SETTINGS)
+    if (!settings.load_odometer()) DEBUG_ECHOLNPGM("No saved odometer");
+  #endif
 }
 
 void BAFSD::reset() {
@@ -73,7 +142,12 @@ void BAFSD::reset() {
   queue.inject(msg);
 
   port = NO_PORT;
-  BAFSD_SEND("M709");
+  TERN_(BAFSD_SENSOR_EVENTS, events = BAFSD_EVENTS_UNKNOWN);
+  #if ENABLED(BAFSD_LOOKAHEAD)
+    if (!busy()) nextPort = NO_PORT;
+    aheadPort = stagedPort = NO_PORT;
+  #endif
+  command(BAFSD_OP_RESET, 0, BAFSD_TIMEOUT, false);
 }
 
 void BAFSD::trigger_camera(const uint16_t d) {
@@ -81,7 +155,7 @@ void BAFSD::trigger_camera(const uint16_t d) {
   sprintf_P(msg, PSTR("M117 BAFS Trigger Cam"));
   queue.inject(msg);
 
-  tx_printf(F("M240 D%d\n"), d);
+  command(BAFSD_OP_CAMERA, d, BAFSD_TIMEOUT, false);
 }
 
 uint8_t BAFSD::current_port() {
@@ -106,275 +180,967 @@ Using filament sensor:
 2. Retract to position before extruder gear: BAFSD_SENSOR_TO_GEAR_DISTANCE
 3. Send PWM Signal to chosen port and wait: BAFSD_SERVO_DELAY
 4. Feed until sensor is triggered, approx: BAFSD_SENSOR_TO_GEAR_DISTANCE, If not triggered, wait for user action
+
+The swap only starts here. Each step is taken from bafsd_loop() once the
+previous move and device reply are done, so the queue keeps answering
+status commands while the device switches.
 */
-void BAFSD::select_port(const uint8_t e) {
-    char msg[40];
+void BAFSD::select_port(uint8_t e) {
+    // A swap may already be running, e.g. when called from the LCD.
+    // Its M709 W can't run from here, so wait for the user in its place.
+    while (busy()) { user_step(); idle(); }
+
+    // Find the port that follows this one, to stage it once this swap is done
+    TERN_(BAFSD_LOOKAHEAD, aheadPort = look_ahead(e));
+
+    #if ENABLED(BAFSD_FAILOVER)
+      // An empty port is served by its backup. With no backup left, try the port anyway.
+      const uint8_t r = route(e);
+      if (r != NO_PORT) e = r;
+    #endif
 
     if (port == NO_PORT) {
-      port = e;
-      nextPort = NO_PORT;
-      tx_printf(F("T%d\n"), e);
-      get_response(BAFSD_TIMEOUT); // Use default timeout, this should not take long
-      if (response == 1) {
-        sprintf_P(msg, PSTR("M117 BAFS Port: %u"), e);
-        queue.inject(msg);
-      } else {
-          sprintf_P(msg, PSTR("M117 Failed Switching Port: %u"), e);
-          queue.inject(msg);
-      }
+      nextPort = e;
+      start_swap(BAFSD_SELECT);
       return;
     }
 
     if (e != port){
       nextPort = e;
       if (too_cold(active_extruder)) {
+        char msg[40];
         sprintf_P(msg, PSTR("M117 Extr too cold."));
         queue.inject(msg);
+        nextPort = NO_PORT;
         return;
       }
 
       // 1. Filament is expected at parking position, which is just below the sensor
       DEBUG_ECHOLNPGM("Unloading to before sensor");
+      retried = false;
+      TERN_(BAFSD_SENSOR_EVENTS, searching = false);
       stepper.enable_extruder();
-      uint8_t filPresent = filament_present();
-      while(filPresent == 1){
-        current_position.e -= 1;
-        line_to_current_position(MMM_TO_MMS(BAFSD_UNLOAD_FEEDRATE));
-        planner.synchronize();
-        filPresent = filament_present();
-      };
-
-      // 2. Retract to position before extruder gear: BAFSD_SENSOR_TO_GEAR_DISTANCE
-      DEBUG_ECHOLNPGM("Unloading to before gear");
-      current_position.e -= BAFSD_SENSOR_TO_GEAR_DISTANCE;
-      line_to_current_position(MMM_TO_MMS(BAFSD_UNLOAD_FEEDRATE));
-      planner.synchronize();
-      stepper.disable_extruder();
+      start_swap(BAFSD_UNLOAD_TO_SENSOR);
+    }
+}
 
-      // 3. Send tool change command and wait
-      bool toolChangeOk = true;
+// Go to the first phase of a swap, stopping first for a new spool if this one is nearly empty
+void BAFSD::start_swap(const BAFSDPhase p) {
+  #if ENABLED(BAFSD_ODOMETER)
+    if (spool_low(nextPort)) {
+      afterCheck = p;
+      set_phase(BAFSD_LOW_SPOOL);
+      return;
+    }
+  #endif
+  set_phase(p);
+}
 
-      DEBUG_ECHOLNPGM("Sending T", e, " to BAFSD");
-      tx_printf(F("T%d\n"), e);
+void BAFSD::set_phase(const BAFSDPhase p) {
+  TERN_(BAFSD_PROFILE, bafsd_stats.phase_done(phase));
+  phase = p;
+  queried = false;
+  attempts = 0;
+  phaseExpire = millis();
+}
 
-      DEBUG_ECHOLNPGM("Move extruder motor to help gripping the filament");
-      const uint16_t slowMargin = 1200; // move extruder motor at the last moment
-      safe_delay(BAFSD_FIL_CHANGE_DURATION - slowMargin);
-      stepper.enable_extruder();
-      current_position.e += 20;
-      line_to_current_position(MMM_TO_MMS(BAFSD_LOAD_FEEDRATE));
-      planner.synchronize();
-      stepper.disable_extruder();
+void BAFSD::move_extruder(const float dist, const feedRate_t fr_mm_s) {
+  current_position.e += dist;
+  line_to_current_position(fr_mm_s);
+}
 
-      get_response(BAFSD_TIMEOUT);
-      if (response != 1) {
-        toolChangeOk = false;
+/**
+ * Take one step of the swap. Called only when the planner is empty,
+ * no reply is outstanding and any hold time has elapsed.
+ */
+void BAFSD::swap_step() {
+  const millis_t ms = millis();
+
+  #if ENABLED(BAFSD_SENSOR_EVENTS)
+    if (searching) end_search();  // A seen edge stands in for a sensor query
+  #endif
+
+  switch (phase) {
+    case BAFSD_IDLE: break;
+
+    case BAFSD_SELECT:
+      if (!queried) {
+        queried = true;
+        command(BAFSD_OP_SELECT, nextPort); // Use default timeout, this should not take long
+        break;
+      }
+      {
+        char msg[40];
+        if (response == 1)
+          sprintf_P(msg, PSTR("M117 BAFS Port: %u"), nextPort);
+        else
+          sprintf_P(msg, PSTR("M117 Failed Switching Port: %u"), nextPort);
+        queue.inject(msg);
       }
-      safe_delay(250);
+      port = nextPort;
+      nextPort = NO_PORT;
+      set_phase(BAFSD_IDLE);
+      break;
 
-      uint8_t fil_present = 0;
-      if (toolChangeOk) {
-        // 4. Feed until sensor is triggered, approx: BAFSD_SENSOR_TO_GEAR_DISTANCE, If not triggered, wait for user action
-        DEBUG_ECHOLNPGM("Loading to sensor");
-        fil_present = load_to_sensor();
-
-        // Sensor is not triggered, possibly because it's not fed properly to the gear, try to feed some and retry
-        if (fil_present != 1){
-          DEBUG_ECHOLNPGM("Loading to sensor failed.");
-          DEBUG_ECHOLNPGM("Retrying (C0).");
-          safe_delay(250);
-          tx_printf(F("C%d\n"), 0);
-          safe_delay(BAFSD_SMALL_FEED_DURATION);
-          get_response(BAFSD_TIMEOUT);
-          safe_delay(250);
-          fil_present = load_to_sensor();
+    #if ENABLED(BAFSD_ODOMETER)
+      // The user puts a new spool on the port, taken to be as long as the old one
+      case BAFSD_LOW_SPOOL:
+        if (queried) break;   // Waiting on M709 W
+        DEBUG_ECHOLNPGM("Port ", nextPort, " spool low: ", remaining(nextPort), "mm");
+        SERIAL_ECHO_MSG("BAFS port ", nextPort, " spool low");
+        ui.status_printf(0, F("BAFS Port %u spool low"), nextPort);
+        queried = true;
+        queue.inject(F("M709 W"));
+        break;
+    #endif
+
+    // 1. Filament is expected at parking position, which is just below the sensor
+    case BAFSD_UNLOAD_TO_SENSOR:
+      if (TERN0(BAFSD_SENSOR_EVENTS, arm_events())) break;
+      if (!queried) { query_sensor(); break; }
+      queried = false;
+      if (response == 1) {
+        #if ENABLED(BAFSD_SENSOR_EVENTS)
+          if (events == BAFSD_EVENTS_ON) {
+            start_search(-(BAFSD_UNLOAD_SEARCH_DISTANCE), MMM_TO_MMS(BAFSD_UNLOAD_FEEDRATE), false);
+            break;
+          }
+        #endif
+        move_extruder(-1, MMM_TO_MMS(BAFSD_UNLOAD_FEEDRATE));
+        break;
+      }
+      set_phase(BAFSD_RETRACT_TO_GEAR);
+      // fall-through
+
+    // 2. Retract to position before extruder gear: BAFSD_SENSOR_TO_GEAR_DISTANCE
+    case BAFSD_RETRACT_TO_GEAR:
+      DEBUG_ECHOLNPGM("Unloading to before gear");
+      move_extruder(-(BAFSD_SENSOR_TO_GEAR_DISTANCE), MMM_TO_MMS(BAFSD_UNLOAD_FEEDRATE));
+      set_phase(BAFSD_DEVICE_SWITCH);
+      break;
+
+    // 3. Send tool change command and move the extruder at the last moment
+    case BAFSD_DEVICE_SWITCH: {
+      stepper.disable_extruder();
+      // A pre-staged filament only has the last stretch to go
+      #if ENABLED(BAFSD_LOOKAHEAD)
+        const bool staged = stagedPort == nextPort;
+        millis_t duration = staged ? BAFSD_STAGED_CHANGE_DURATION : BAFSD_FIL_CHANGE_DURATION;
+        stagedPort = NO_PORT;
+      #else
+        constexpr bool staged = false;
+        millis_t duration = BAFSD_FIL_CHANGE_DURATION;
+      #endif
+      millis_t timeout = duration + BAFSD_TIMEOUT;
+      #if ENABLED(BAFSD_LEARN_SWITCH_TIME)
+        // Staged switches only feed the last stretch, so only full switches are learned
+        timeSwitch = !staged && port < EXTRUDERS && nextPort < EXTRUDERS;
+        if (timeSwitch && switch_time[port][nextPort]) {
+          duration = switch_time[port][nextPort];
+          // Still give a slower than usual switch the full time
+          NOLESS(timeout, duration + BAFSD_TIMEOUT);
         }
+      #else
+        UNUSED(staged);
+      #endif
+      DEBUG_ECHOLNPGM("Sending T", nextPort, " to BAFSD, expect ", duration, "ms");
+      command(BAFSD_OP_SELECT, nextPort, timeout);
+      const uint16_t slowMargin = 1200; // move extruder motor at the last moment
+      set_phase(BAFSD_GRIP_ASSIST);
+      phaseExpire = ms + duration - _MIN(duration, slowMargin);
+    } break;
+
+    case BAFSD_GRIP_ASSIST:
+      if (!queried) {
+        // A learned estimate may run long, so also go as soon as the device is done
+        if (PENDING(ms, phaseExpire) && TERN1(BAFSD_LEARN_SWITCH_TIME, waitingResponse)) break;
+        queried = true;
+        DEBUG_ECHOLNPGM("Move extruder motor to help gripping the filament");
+        stepper.enable_extruder();
+        move_extruder(20, MMM_TO_MMS(BAFSD_LOAD_FEEDRATE));
+        break;
+      }
+      stepper.disable_extruder();
+      if (waitingResponse) break;
+      switchOk = (response == 1);
+      #if ENABLED(BAFSD_LEARN_SWITCH_TIME)
+        if (switchOk && timeSwitch) learn_switch_time(port, nextPort, replyTime - commandIssueTime);
+      #endif
+      if (switchOk) {
+        DEBUG_ECHOLNPGM("Loading to sensor");
+        set_phase(BAFSD_LOAD_TO_SENSOR);
       }
+      else
+        set_phase(BAFSD_USER_RECOVERY);
+      hold(250);
+      break;
 
-      while (fil_present != 1){
-        DEBUG_ECHOLNPGM("Filament change failed: ", fil_present, "-", toolChangeOk);
-        constexpr xyz_pos_t park_point = NOZZLE_PARK_POINT;
-        if (pause_print(0, park_point, true, 0)) {
-          wait_for_confirmation(true, 5);
-          resume_print(0, 0, 0, 0, 0);
-          safe_delay(250);
-          fil_present = load_to_sensor();
+    // 4. Feed until sensor is triggered, approx: BAFSD_SENSOR_TO_GEAR_DISTANCE, If not triggered, wait for user action
+    case BAFSD_LOAD_TO_SENSOR:
+      if (!queried) { query_sensor(); break; }
+      queried = false;
+      #if ENABLED(BAFSD_SENSOR_EVENTS)
+        // One move up to the sensor, stopped on the edge
+        if (response == 0 && events == BAFSD_EVENTS_ON && attempts++ == 0) {
+          stepper.enable_extruder();
+          start_search(BAFSD_SENSOR_TO_GEAR_DISTANCE, MMM_TO_MMS(BAFSD_LOAD_FEEDRATE), true);
+          break;
+        }
+      #endif
+      if (response == 0 && TERN1(BAFSD_SENSOR_EVENTS, events != BAFSD_EVENTS_ON)) {
+        // Attempt to load the filament, at a time, for 3s
+        if (attempts == 0 || ELAPSED(ms, phaseExpire)) {
+          stepper.disable_extruder();
+          if (attempts < BAFSD_ATTEMPTS_NR) { attempts++; phaseExpire = ms + 3000; }
+        }
+        if (PENDING(ms, phaseExpire)) {
+          stepper.enable_extruder();
+          move_extruder(1, MMM_TO_MMS(BAFSD_LOAD_FEEDRATE));
+          hold(100);
+          break;
         }
-        safe_delay(250);
       }
+      stepper.disable_extruder();
+      DEBUG_ECHOLNPGM("Load to sensor: ", response);
+      if (response == 1) { finish_swap(); break; }
 
-      sprintf_P(msg, PSTR("M117 BAFS Port: %u"), e);
-      queue.inject(msg);
-      port = e;
-      nextPort = NO_PORT;
-    }
+      // Sensor is not triggered, possibly because it's not fed properly to the gear, try to feed some and retry
+      DEBUG_ECHOLNPGM("Loading to sensor failed.");
+      set_phase(retried ? BAFSD_USER_RECOVERY : BAFSD_RETRY);
+      hold(250);
+      break;
+
+    case BAFSD_RETRY:
+      if (!queried) {
+        DEBUG_ECHOLNPGM("Retrying (C0).");
+        queried = retried = true;
+        command(BAFSD_OP_FEED, 0, BAFSD_SMALL_FEED_DURATION + BAFSD_TIMEOUT);
+        hold(BAFSD_SMALL_FEED_DURATION);
+        break;
+      }
+      set_phase(BAFSD_LOAD_TO_SENSOR);
+      hold(250);
+      break;
+
+    case BAFSD_USER_RECOVERY: {
+      if (queried) break;     // Waiting on M709 W
+      DEBUG_ECHOLNPGM("Filament change failed: ", response, "-", switchOk);
+      #if ENABLED(BAFSD_FAILOVER)
+        // Take the port that won't load for empty and go on with its backup
+        const uint8_t b = fail_over(nextPort);
+        if (b != NO_PORT) {
+          nextPort = b;
+          retried = false;
+          stepper.enable_extruder();
+          set_phase(BAFSD_RETRACT_TO_GEAR);
+          break;
+        }
+      #endif
+      // Waiting for the user is blocking by nature, so it's queued
+      queried = true;
+      queue.inject(F("M709 W"));
+    } break;
+  }
 }
 
-// 0 = not present, 1 = present, 2 = error
-uint8_t BAFSD::filament_present(){
-  char msg[30];
+/**
+ * Park and wait for the user to load a new spool or fix a failed load,
+ * then go on with the swap. Run from M709 W, which the swap queues since
+ * the print can't be paused from idle().
+ */
+void BAFSD::user_step() {
+  if (!queried || !(phase == BAFSD_USER_RECOVERY || TERN0(BAFSD_ODOMETER, phase == BAFSD_LOW_SPOOL))) return;
 
-  DEBUG_ECHOLNPGM("Sending M412 to BAFSD");
-  BAFSD_SEND("M412");
-  get_response(BAFSD_TIMEOUT);
-  if (response == 0) {
-    return 0;
-  } else if (response == 1) {
-    return 1;
-  } else {
-    sprintf_P(msg, PSTR("M117 BAFSD Error: F. Sensor"));
-    queue.inject(msg);
-    return 2;
+  constexpr xyz_pos_t park_point = NOZZLE_PARK_POINT;
+  if (pause_print(0, park_point, true, 0)) {
+    wait_for_confirmation(true, 5);
+    resume_print(0, 0, 0, 0, 0);
+    #if ENABLED(BAFSD_ODOMETER)
+      if (phase == BAFSD_LOW_SPOOL) {
+        new_spool(nextPort, spool_mm[nextPort]);
+        save_odometer();
+        set_phase(afterCheck);
+      }
+      else
+    #endif
+        set_phase(BAFSD_LOAD_TO_SENSOR);
   }
+  else
+    queried = false;          // Ask again
+  hold(250);
 }
 
-uint8_t BAFSD::load_to_sensor(){
-  bool fil_loaded = 0;
-  for (uint8_t i = 0; i < BAFSD_ATTEMPTS_NR; i++) {
-    // Done as soon as filament is present
-    fil_loaded = filament_present();
-    if (fil_loaded != 0) break;
-
-    // Attempt to load the filament, at a time, for 3s
-    stepper.enable_extruder();
-    const millis_t expire_ms = millis() + 3000;
-    while ((fil_loaded == 0) && PENDING(millis(), expire_ms)) {
-      current_position.e += 1;
-      line_to_current_position(MMM_TO_MMS(BAFSD_LOAD_FEEDRATE));
-      planner.synchronize();
-      fil_loaded = filament_present();
-      safe_delay(100);
+#if ENABLED(BAFSD_LEARN_SWITCH_TIME)
+
+  /**
+   * Moving average of the time from the select command to the device's 'ok'.
+   * The first sample is taken as is, later ones count for a quarter.
+   */
+  void BAFSD::learn_switch_time(const uint8_t from, const uint8_t to, const millis_t ms) {
+    uint16_t &t = switch_time[from][to];
+    const int32_t sample = _MIN(ms, millis_t(UINT16_MAX));
+    t = t ? t + (sample - t) / 4 : sample;
+    DEBUG_ECHOLNPGM("Switch ", from, ">", to, ": ", sample, "ms, learned ", t, "ms");
+  }
+
+  void BAFSD::reset_switch_times() {
+    ZERO(switch_time);
+  }
+
+#endif
+
+#if ENABLED(BAFSD_ODOMETER)
+
+  /**
+   * Count the E steps made since the last call against the port feeding now,
+   * so moves cut short by a quick stop count only as far as they went.
+   * While a swap loads the next port its moves belong to that port, the
+   * unload moves to the old one.
+   */
+  void BAFSD::count_steps() {
+    hal.isr_off();
+    const int32_t e = stepper.position(E_AXIS), steps = e - countedE;
+    countedE = e;
+    hal.isr_on();
+    const uint8_t p = WITHIN(phase, BAFSD_GRIP_ASSIST, BAFSD_USER_RECOVERY) ? nextPort : port;
+    if (p < EXTRUDERS) fedSteps[p] += steps;
+  }
+
+  // Move the counted steps to used_mm, in large amounts to keep the float precise
+  void BAFSD::fold_steps(const bool all) {
+    count_steps();
+    const int32_t some = planner.settings.axis_steps_per_mm[E_AXIS] * 10;
+    LOOP_L_N(p, EXTRUDERS) {
+      const int32_t steps = fedSteps[p];
+      if (all || ABS(steps) >= some) {
+        fedSteps[p] = 0;
+        used_mm[p] += steps * planner.mm_per_step[E_AXIS];
+      }
     }
-    stepper.disable_extruder();
   }
-  DEBUG_ECHOLNPGM("Load to sensor: ", fil_loaded);
-  return fil_loaded;
-}
 
-void BAFSD::bafsd_loop() {
-  const millis_t expire_ms = commandIssueTime + timeOut;
-  millis_t now = millis();
-  while(waitingResponse && PENDING(now, expire_ms)){
-    if (rx_ok()) {
-      DEBUG_ECHOLNPGM("Rx: ok");
-      response = 1;
-      waitingResponse = false;
-    } else if (rx_no()) {
-      DEBUG_ECHOLNPGM("Rx: no");
-      response = 0;
-      waitingResponse = false;
+  float BAFSD::used(const uint8_t p) {
+    fold_steps();
+    return used_mm[p];
+  }
+
+  bool BAFSD::spool_low(const uint8_t p) {
+    return BAFSD_LOW_SPOOL_MM > 0 && p < EXTRUDERS && spool_mm[p] > 0 && remaining(p) < BAFSD_LOW_SPOOL_MM;
+  }
+
+  void BAFSD::new_spool(const uint8_t p, const float mm) {
+    fold_steps();
+    spool_mm[p] = mm;
+    used_mm[p] = 0;
+  }
+
+  void BAFSD::save_odometer() {
+    TERN(EEPROM_SETTINGS, settings.store_odometer(), fold_steps());
+  }
+
+  /**
+   * Save the counts at the end of each print and every BAFSD_ODOMETER_SAVE_INTERVAL
+   * minutes of printing, so a reset loses little of what was fed
+   */
+  void BAFSD::autosave_odometer() {
+    static bool was_printing; // = false
+    const bool printing = printJobOngoing();
+    bool save = was_printing && !printing;
+
+    #if BAFSD_ODOMETER_SAVE_INTERVAL > 0
+      static millis_t next_save_ms; // = 0
+      const millis_t ms = millis();
+      if (printing && (!was_printing || ELAPSED(ms, next_save_ms))) {
+        save = was_printing;
+        next_save_ms = ms + MIN_TO_MS(BAFSD_ODOMETER_SAVE_INTERVAL);
+      }
+    #endif
+
+    was_printing = printing;
+    if (!save) return;
+    #if ENABLED(PRINTCOUNTER_SYNC)
+      if (printing) planner.synchronize();
+    #endif
+    save_odometer();
+  }
+
+#endif
+
+#if ENABLED(BAFSD_FAILOVER)
+
+  /**
+   * The port serving port p: p itself, or the first backup in its chain
+   * that isn't empty. NO_PORT if none is left.
+   */
+  uint8_t BAFSD::route(uint8_t p) {
+    LOOP_L_N(i, EXTRUDERS) {  // The table may loop
+      if (p >= EXTRUDERS || !TEST(emptyPorts, p)) break;
+      p = backup[p] < 0 ? NO_PORT : backup[p];
     }
-    now = millis();
+    return p < EXTRUDERS && !TEST(emptyPorts, p) ? p : NO_PORT;
   }
 
-  if (waitingResponse){
-    DEBUG_ECHOLNPGM("Time out: ", response, " - ", now, " - ", expire_ms, " - ", waitingResponse);
-    response = 2;
-    waitingResponse = false;
+  // Mark port p empty and return the port to use instead, or NO_PORT if it has no backup
+  uint8_t BAFSD::fail_over(const uint8_t p) {
+    if (p >= EXTRUDERS) return NO_PORT;
+    SBI(emptyPorts, p);
+    const uint8_t b = route(p);
+    if (b == NO_PORT) {
+      CBI(emptyPorts, p);
+      return NO_PORT;
+    }
+    SERIAL_ECHO_MSG("BAFS port ", p, " empty, using ", b);
+    ui.status_printf(0, F("BAFS Port %u empty > %u"), p, b);
+    failingOver = true;
+    return b;
   }
-}
 
-void BAFSD::get_response(const int t) {
-  timeOut = t;
-  commandIssueTime = millis();
-  waitingResponse = true;
-  DEBUG_ECHOLNPGM("Waiting for response: ", commandIssueTime, ", t: ", timeOut);
+  /**
+   * Called on a filament runout. Queues the swap to the backup of the
+   * current port and returns true, or returns false to pause as usual.
+   * The runout handler runs from idle(), so the swap is left to M714 F.
+   */
+  bool BAFSD::runout_failover() {
+    if (busy()) return false;
+    if (failingOver) return true;
+    if (fail_over(port) == NO_PORT) return false;
+    queue.inject(F("M714 F"));
+    return true;
+  }
 
-  KEEPALIVE_STATE(PAUSED_FOR_USER);
+  // Swap to the backup found by runout_failover()
+  void BAFSD::swap_to_backup() {
+    if (!failingOver || busy()) return;
+    const uint8_t b = route(port);
+    if (b != NO_PORT && b != port) select_port(b); else failingOver = false;
+  }
 
-  while (waitingResponse) {
-    idle();
+  void BAFSD::reset_backup_ports() {
+    constexpr int8_t ports[] = BAFSD_BACKUP_PORTS;
+    static_assert(COUNT(ports) == EXTRUDERS, "BAFSD_BACKUP_PORTS must have EXTRUDERS values.");
+    COPY(backup, ports);
   }
-  DEBUG_ECHOLNPGM("Response: ", response);
+
+#endif
+
+void BAFSD::finish_swap() {
+  char msg[40];
+  sprintf_P(msg, PSTR("M117 BAFS Port: %u"), nextPort);
+  queue.inject(msg);
+  port = nextPort;
+  nextPort = NO_PORT;
+  set_phase(BAFSD_IDLE);
+  TERN_(BAFSD_PROFILE, bafsd_stats.swap_done(port));
+  #if ENABLED(BAFSD_FAILOVER)
+    // The backup is loaded, so watch for the next runout
+    if (failingOver) {
+      failingOver = false;
+      TERN_(HAS_FILAMENT_SENSOR, runout.reset());
+    }
+  #endif
 }
 
+#if ENABLED(BAFSD_SENSOR_EVENTS)
+
+  /**
+   * Ask the device to report sensor edges, once after each reset.
+   * Returns true while the request is outstanding.
+   */
+  bool BAFSD::arm_events() {
+    switch (events) {
+      case BAFSD_EVENTS_UNKNOWN:
+        command(BAFSD_OP_EVENTS);
+        events = BAFSD_EVENTS_PENDING;
+        return true;
+      case BAFSD_EVENTS_PENDING:
+        events = response == 1 ? BAFSD_EVENTS_ON : BAFSD_EVENTS_OFF;
+        DEBUG_ECHOLNPGM("Sensor events: ", events == BAFSD_EVENTS_ON);
+        break;
+      default: break;
+    }
+    return false;
+  }
+
+  /**
+   * Plan one E move and let the sensor edge stop it,
+   * the way an endstop stops a homing move
+   */
+  void BAFSD::start_search(const float dist, const feedRate_t fr_mm_s, const bool present) {
+    searchFor = present;
+    edgeSeen = false;
+    searching = true;
+    move_extruder(dist, fr_mm_s);
+  }
+
+  /**
+   * The search move is over. If it was cut short by the edge,
+   * take the E position from the steppers and use the edge as the reading.
+   * Otherwise leave it to a regular sensor query.
+   */
+  void BAFSD::end_search() {
+    searching = false;
+    if (!edgeSeen) return;
+    set_current_from_steppers_for_axis(E_AXIS);
+    sync_plan_position_e();
+    DEBUG_ECHOLNPGM("Sensor edge at E steps ", edgeSteps);
+    queried = true;
+    response = searchFor;
+  }
+
+#endif // BAFSD_SENSOR_EVENTS
+
 /**
- * Transfer data to BAFSD, no argument
+ * The device reported a sensor change. Stop a search move waiting for it.
  */
-void BAFSD::tx_str(FSTR_P fstr) {
-  clear_rx_buffer();
-  PGM_P pstr = FTOP(fstr);
-  while (const char c = pgm_read_byte(pstr)) { BAFSD_SERIAL.write(c); pstr++; }
+void BAFSD::sensor_edge(const bool present) {
+  DEBUG_ECHOLNPGM("Rx: F", present);
+  #if ENABLED(BAFSD_SENSOR_EVENTS)
+    if (searching && !edgeSeen && present == searchFor) {
+      // Latch E and abort the move like an endstop hit. Unlike planner.quick_stop()
+      // this doesn't lock out new moves for a second, so the swap goes straight on.
+      edgeSteps = stepper.position(E_AXIS);
+      stepper.quick_stop();
+      edgeSeen = true;
+    }
+  #else
+    UNUSED(present);
+  #endif
 }
 
 /**
- * Transfer data to BAFSD, single argument
+ * Send M412 to BAFSD, the reply is 0 = not present, 1 = present, 2 = error
  */
-void BAFSD::tx_printf(FSTR_P format, int argument = -1) {
-  clear_rx_buffer();
-  const uint8_t len = sprintf_P(tx_buffer, FTOP(format), argument);
-  LOOP_L_N(i, len) BAFSD_SERIAL.write(tx_buffer[i]);
+void BAFSD::query_sensor() {
+  DEBUG_ECHOLNPGM("Sending M412 to BAFSD");
+  queried = true;
+  command(BAFSD_OP_SENSOR);
 }
 
 /**
- * Transfer data to BAFSD, two arguments
+ * Skip leading spaces and a line number
  */
-void BAFSD::tx_printf(FSTR_P format, int argument1, int argument2) {
-  clear_rx_buffer();
-  const uint8_t len = sprintf_P(tx_buffer, FTOP(format), argument1, argument2);
-  LOOP_L_N(i, len) BAFSD_SERIAL.write(tx_buffer[i]);
+const char* BAFSD::skip_line_number(const char *cmd) {
+  while (*cmd == ' ') cmd++;
+  if (*cmd == 'N') {
+    while (*cmd && *cmd != ' ') cmd++;
+    while (*cmd == ' ') cmd++;
+  }
+  return cmd;
 }
 
 /**
- * Check if we received 'ok' from BAFSD
+ * Commands that don't touch motion or the tool and
+ * can be answered while a swap is in progress
  */
-bool BAFSD::rx_ok() {
-  if (BAFSD_RECV("ok")) {
-    return true;
+bool BAFSD::passthrough(const char *cmd) {
+  cmd = skip_line_number(cmd);
+  if (*cmd != 'M' || !NUMERIC(cmd[1])) return false;
+  switch (atoi(cmd + 1)) {
+    case 27: case 31: case 73: case 105: case 114: case 115:
+    case 117: case 118: case 119: case 155:
+      return true;
   }
   return false;
 }
 
+#if ENABLED(BAFSD_LOOKAHEAD)
+
+  // The tool selected by a command line, or NO_PORT
+  uint8_t BAFSD::tool_in_line(const char *cmd) {
+    cmd = skip_line_number(cmd);
+    if (*cmd != 'T' || !NUMERIC(cmd[1])) return NO_PORT;
+    const int t = atoi(cmd + 1);
+    return t < EXTRUDERS ? t : NO_PORT;
+  }
+
+  /**
+   * Find the first port other than 'e' selected by a queued command
+   * or, when printing from SD, in the next BAFSD_LOOKAHEAD_BYTES of the file.
+   * The SD file is scanned only from the command context.
+   */
+  uint8_t BAFSD::look_ahead(const uint8_t e, const bool scan_sd/*=true*/) {
+    GCodeQueue::RingBuffer &rb = queue.ring_buffer;
+    for (uint8_t i = 0, r = rb.index_r; i < rb.length; ++i) {
+      const uint8_t t = tool_in_line(rb.commands[r].buffer);
+      if (t != NO_PORT && t != e) return t;
+      if (++r >= BUFSIZE) r = 0;
+    }
+
+    #if ENABLED(SDSUPPORT)
+      if (scan_sd && IS_SD_PRINTING()) {
+        const uint32_t pos = card.getIndex();
+        char line[12], chunk[32];
+        uint8_t len = 0;
+        uint8_t found = NO_PORT;
+        for (uint16_t n = 0; n < BAFSD_LOOKAHEAD_BYTES && found == NO_PORT; n += sizeof(chunk)) {
+          const int16_t got = card.read(chunk, sizeof(chunk));
+          if (got <= 0) break;
+          LOOP_L_N(i, uint16_t(got)) {
+            const char c = chunk[i];
+            if (c == '\n' || c == '\r') {
+              line[len] = '\0';
+              const uint8_t t = tool_in_line(line);
+              if (t != NO_PORT && t != e) { found = t; break; }
+              len = 0;
+            }
+            else if (len < sizeof(line) - 1)
+              line[len++] = c;
+          }
+        }
+        card.setIndex(pos);
+        return found;
+      }
+    #else
+      UNUSED(scan_sd);
+    #endif
+
+    return NO_PORT;
+  }
+
+  /**
+   * Tell the device to bring the next port's filament up to the merge point
+   * while the current one is printing
+   */
+  void BAFSD::stage_next() {
+    const millis_t ms = millis();
+
+    if (stagePending) {
+      if (ELAPSED(ms, stageIssueTime + BAFSD_TIMEOUT)) {
+        DEBUG_ECHOLNPGM("Stage time out");
+        stagePending = false;
+      }
+      return;
+    }
+
+    if (busy() || waitingResponse || port == NO_PORT) return;
+
+    if (aheadPort != NO_PORT) {
+      nextPort = aheadPort;
+      aheadPort = NO_PORT;
+    }
+    else if (nextPort == NO_PORT && ELAPSED(ms, next_scan_ms)) {
+      // Commands may have arrived since the last tool change
+      next_scan_ms = ms + 1000;
+      nextPort = look_ahead(port, false);
+    }
+
+    #if ENABLED(BAFSD_FAILOVER)
+      if (nextPort != NO_PORT) nextPort = route(nextPort);
+    #endif
+
+    if (nextPort == NO_PORT || nextPort == port || nextPort == stagedPort) return;
+
+    DEBUG_ECHOLNPGM("Staging port ", nextPort);
+    stagePort = nextPort;
+    stagePending = true;
+    stageIssueTime = ms;
+    stageSeq = command(BAFSD_OP_STAGE, stagePort, BAFSD_TIMEOUT, false);
+  }
+
+#endif // BAFSD_LOOKAHEAD
+
+void BAFSD::bafsd_loop() {
+  rx_process();
+  dispatch_events();
+  #if ENABLED(BAFSD_ODOMETER)
+    fold_steps(false);
+    autosave_odometer();
+  #endif
+
+  if (waitingResponse) {
+    if (ELAPSED(millis(), commandIssueTime + timeOut)) {
+      DEBUG_ECHOLNPGM("Time out: ", response, " - ", millis(), " - ", commandIssueTime + timeOut, " - ", waitingResponse);
+      response = 2;
+      waitingResponse = false;
+      // A late reply is dropped by its sequence ID, not taken for the next request's
+      TERN_(BAFSD_FRAMED_LINK, inflight[waitSeq % BAFSD_MAX_INFLIGHT].seq = 0);
+    }
+  }
+
+  #if ENABLED(BAFSD_FRAMED_LINK)
+    if (negotiate()) return;
+  #endif
+
+  TERN_(BAFSD_LOOKAHEAD, stage_next());
+
+  // Advance the swap. Steps only wait on the device or the planner, never block.
+  if (!busy() || stepping) return;
+  if (PENDING(millis(), holdUntil) || planner.busy()) return;
+  if (waitingResponse && phase != BAFSD_GRIP_ASSIST) return;
+  if (TERN0(BAFSD_LOOKAHEAD, stagePending)) return;
+
+  stepping = true;
+  swap_step();
+  stepping = false;
+}
+
 /**
- * Check if we received 'no' from BAFSD
+ * Mark a command as sent, bafsd_loop() collects the reply
  */
-bool BAFSD::rx_no() {
-  if (BAFSD_RECV("no")) {
-    return true;
+void BAFSD::request(const int t) {
+  timeOut = t;
+  commandIssueTime = millis();
+  waitingResponse = true;
+  DEBUG_ECHOLNPGM("Waiting for response: ", commandIssueTime, ", t: ", timeOut);
+}
+
+/**
+ * Send a command to BAFSD. With 'wait' the swap waits for the
+ * reply in 'response', otherwise the reply is just consumed.
+ * Returns the sequence ID the reply is matched by.
+ */
+uint8_t BAFSD::command(const BAFSDOp op, const uint32_t arg/*=0*/, const int t/*=BAFSD_TIMEOUT*/, const bool wait/*=true*/) {
+  #if ENABLED(BAFSD_FRAMED_LINK)
+    // Until the device accepts framing only HELLO is sent as a frame
+    const uint8_t seq = (link == BAFSD_LINK_FRAMED || op == BAFSD_OP_HELLO) ? tx_frame(op, arg) : tx_ascii(op, arg, t);
+  #else
+    const uint8_t seq = tx_ascii(op, arg, t);
+  #endif
+  if (wait) {
+    waitSeq = seq;
+    response = 99;
+    request(t);
   }
-  return false;
+  return seq;
 }
 
 /**
- * Check if the data received ends with the given string.
+ * Transfer a command to BAFSD as an ASCII line.
+ * Returns the sequence ID its reply will be posted with.
  */
-bool BAFSD::rx_str(FSTR_P fstr) {
-  PGM_P pstr = FTOP(fstr);
+uint8_t BAFSD::tx_ascii(const BAFSDOp op, const uint32_t arg, const int t) {
+  PGM_P fmt;
+  switch (op) {
+    case BAFSD_OP_SELECT: fmt = PSTR("T%u\n"); break;
+    case BAFSD_OP_SENSOR: fmt = PSTR("M412\n"); break;
+    case BAFSD_OP_FEED:   fmt = PSTR("C%u\n"); break;
+    case BAFSD_OP_CAMERA: fmt = PSTR("M240 D%u\n"); break;
+    case BAFSD_OP_RESET:  fmt = PSTR("M709\n"); break;
+    case BAFSD_OP_EVENTS: fmt = PSTR("M412 E1\n"); break;
+    case BAFSD_OP_STAGE:  fmt = PSTR("P%u\n"); break;
+    default: return 0;
+  }
+  clear_rx_buffer();
+  const uint8_t len = sprintf_P(tx_buffer, fmt, uint16_t(arg));
+  LOOP_L_N(i, len) BAFSD_SERIAL.write(tx_buffer[i]);
 
-  uint8_t i = strlen(rx_buffer);
+  // A reply later than its timeout still takes its line off the list, so it isn't
+  // taken for the next request's. A line with no reply at all is given up on later.
+  expire_lines();
+  if (sentLines.isFull()) DEBUG_ECHOLNPGM("No reply to seq ", sentLines.dequeue().seq);
+  sentLines.enqueue({ next_seq(), op, millis() + t + BAFSD_TIMEOUT });
+  return txSeq;
+}
 
-  while (BAFSD_SERIAL.available()) {
-    rx_buffer[i++] = BAFSD_SERIAL.read();
+/**
+ * Give up on the lines that should long have been answered
+ */
+void BAFSD::expire_lines() {
+  while (!sentLines.isEmpty() && ELAPSED(millis(), sentLines.peek().expire))
+    DEBUG_ECHOLNPGM("No reply to seq ", sentLines.dequeue().seq);
+}
 
-    if (i == sizeof(rx_buffer) - 1) {
-      DEBUG_ECHOLNPGM("rx buffer overrun");
-      break;
+#if ENABLED(BAFSD_FRAMED_LINK)
+
+  /**
+   * Transfer a command to BAFSD as a frame:
+   *   SYNC LEN SEQ OP PAYLOAD[LEN] CRC16(hi lo)
+   * The CRC covers LEN to the end of the payload.
+   * Returns the sequence ID the reply will carry.
+   */
+  uint8_t BAFSD::tx_frame(const BAFSDOp op, const uint32_t arg) {
+    uint8_t len;
+    switch (op) {
+      case BAFSD_OP_HELLO:  len = 4; break;
+      case BAFSD_OP_CAMERA: len = 2; break;
+      case BAFSD_OP_SELECT:
+      case BAFSD_OP_FEED:
+      case BAFSD_OP_STAGE:  len = 1; break;
+      default:              len = 0; break;
+    }
+
+    next_seq();
+
+    uint8_t frame[4 + BAFSD_FRAME_PAYLOAD + 2];
+    frame[0] = BAFSD_FRAME_SYNC;
+    frame[1] = len;
+    frame[2] = txSeq;
+    frame[3] = op;
+    LOOP_L_N(i, len) frame[4 + i] = uint8_t(arg >> (8 * i)); // Little-endian
+    uint16_t crc = 0;
+    crc16(&crc, &frame[1], 3 + len);
+    frame[4 + len] = crc >> 8;
+    frame[5 + len] = crc & 0xFF;
+    LOOP_L_N(i, 6 + len) BAFSD_SERIAL.write(frame[i]);
+
+    // The slot of the oldest request is reused
+    Inflight &slot = inflight[txSeq % BAFSD_MAX_INFLIGHT];
+    if (slot.seq) DEBUG_ECHOLNPGM("No reply to seq ", slot.seq);
+    slot.seq = txSeq;
+    slot.op = op;
+    return txSeq;
+  }
+
+  /**
+   * Assemble a frame one byte at a time, resyncing on a bad length or CRC
+   */
+  void BAFSD::rx_frame_byte(const uint8_t c) {
+    uint8_t * const buf = (uint8_t*)rx_buffer;
+    if (rx_len == 0) {
+      if (c == BAFSD_FRAME_SYNC) buf[rx_len++] = c;
+      return;
+    }
+    buf[rx_len++] = c;
+    if (rx_len == 2 && c > BAFSD_FRAME_PAYLOAD) { rx_len = 0; return; }
+    if (rx_len < 4 || rx_len < 6 + buf[1]) return;
+
+    const uint8_t len = buf[1];
+    rx_len = 0;
+    uint16_t crc = 0;
+    crc16(&crc, &buf[1], 3 + len);
+    if (crc != ((uint16_t(buf[4 + len]) << 8) | buf[5 + len])) {
+      DEBUG_ECHOLNPGM("Rx: bad CRC");
+      return;
     }
+    rx_frame(buf[2], buf[3], &buf[4], len);
   }
-  rx_buffer[i] = '\0';
 
-  uint8_t len = strlen_P(pstr);
+  /**
+   * Handle a received frame: a sensor edge or the reply to a request
+   */
+  void BAFSD::rx_frame(const uint8_t seq, const uint8_t op, const uint8_t * const data, const uint8_t len) {
+    if (op == BAFSD_OP_EDGE) {
+      if (len) post_event(BAFSD_EV_EDGE, 0, data[0]);
+      return;
+    }
+    if (!(op & BAFSD_OP_REPLY)) return;
 
-  if (i < len) return false;
+    Inflight &slot = inflight[seq % BAFSD_MAX_INFLIGHT];
+    if (!seq || slot.seq != seq || slot.op != (op & ~BAFSD_OP_REPLY)) {
+      DEBUG_ECHOLNPGM("Rx: stale reply ", seq);
+      return;
+    }
+    slot.seq = 0;
 
-  pstr += len;
+    const uint8_t status = len ? data[0] : 2;
+    DEBUG_ECHOLNPGM("Rx: seq ", seq, " op ", slot.op, " = ", status);
+    post_event(BAFSD_EV_REPLY, seq, status);
+  }
 
-  while (len--) {
-    char c0 = pgm_read_byte(pstr--), c1 = rx_buffer[i--];
-    if (c0 == c1) continue;
-    if (c0 == '\r' && c1 == '\n') continue;  // match cr as lf
-    if (c0 == '\n' && c1 == '\r') continue;  // match lf as cr
-    return false;
+  /**
+   * Offer the framed protocol at a higher baud rate. A device that
+   * doesn't answer stays on ASCII at BAFSD_BAUD.
+   * Returns true while the outcome is pending.
+   */
+  bool BAFSD::negotiate() {
+    switch (link) {
+      case BAFSD_LINK_UNKNOWN:
+        link = BAFSD_LINK_NEGOTIATE;
+        command(BAFSD_OP_HELLO, BAFSD_FRAMED_BAUD);
+        return true;
+      case BAFSD_LINK_NEGOTIATE:
+        if (waitingResponse) return true;
+        if (response == 1) {
+          // The device switches right after its reply
+          BAFSD_SERIAL.begin(BAFSD_FRAMED_BAUD);
+          link = BAFSD_LINK_FRAMED;
+        }
+        else {
+          link = BAFSD_LINK_ASCII;
+          BAFSD_SERIAL.write('\n'); // End the line an ASCII parser saw
+        }
+        rx_len = 0;
+        DEBUG_ECHOLNPGM("Framed link: ", link == BAFSD_LINK_FRAMED);
+        return false;
+      default: return false;
+    }
+  }
+
+#endif // BAFSD_FRAMED_LINK
+
+/**
+ * Collect bytes from BAFSD and turn each complete line or frame
+ * into an event. Does a bounded amount of work per call.
+ */
+void BAFSD::rx_process() {
+  // Bytes beyond the budget wait in the interrupt-fed serial buffer
+  for (uint8_t n = BAFSD_RX_BUDGET; n && BAFSD_SERIAL.available(); --n) {
+    const char c = BAFSD_SERIAL.read();
+    #if ENABLED(BAFSD_FRAMED_LINK)
+      if (link != BAFSD_LINK_ASCII) { rx_frame_byte(c); continue; }
+    #endif
+    if (c == '\n' || c == '\r') {
+      if (rx_len) {
+        rx_buffer[rx_len] = '\0';
+        rx_line();
+        rx_len = 0;
+      }
+    }
+    else if (rx_len < sizeof(rx_buffer) - 1)
+      rx_buffer[rx_len++] = c;
+    else
+      DEBUG_ECHOLNPGM("rx buffer overrun");
+  }
+}
+
+/**
+ * Handle one line from BAFSD: a reply ("ok" / "no") or a sensor edge ("F0" / "F1")
+ */
+void BAFSD::rx_line() {
+  if (rx_buffer[0] == 'F' && (rx_buffer[1] == '0' || rx_buffer[1] == '1') && rx_buffer[2] == '\0')
+    post_event(BAFSD_EV_EDGE, 0, rx_buffer[1] == '1');
+  else {
+    const bool ok = strcmp_P(rx_buffer, PSTR("ok")) == 0;
+    if (!ok && strcmp_P(rx_buffer, PSTR("no")) != 0) return;
+    expire_lines();
+    if (sentLines.isEmpty()) { DEBUG_ECHOLNPGM("Rx: unexpected reply"); return; }
+    const Inflight line = sentLines.dequeue();
+    DEBUG_ECHOLNPGM("Rx: seq ", line.seq, " op ", line.op, " = ", ok);
+    post_event(BAFSD_EV_REPLY, line.seq, ok);
+  }
+}
+
+void BAFSD::post_event(const BAFSDEventType type, const uint8_t seq, const uint8_t value) {
+  if (!rx_events.enqueue({ type, seq, value }))
+    DEBUG_ECHOLNPGM("rx event queue full");
+}
+
+/**
+ * Hand completed replies to the waiting request and sensor edges to the swap
+ */
+void BAFSD::dispatch_events() {
+  while (!rx_events.isEmpty()) {
+    const BAFSDEvent ev = rx_events.dequeue();
+    switch (ev.type) {
+      case BAFSD_EV_EDGE: sensor_edge(ev.value); break;
+      case BAFSD_EV_REPLY:
+        #if ENABLED(BAFSD_LOOKAHEAD)
+          if (stagePending && ev.seq == stageSeq) {
+            stagePending = false;
+            stagedPort = ev.value == 1 ? stagePort : NO_PORT;
+            break;
+          }
+        #endif
+        if (!waitingResponse || ev.seq != waitSeq) {
+          DEBUG_ECHOLNPGM("Rx: seq ", ev.seq, " not awaited");
+          break;
+        }
+        DEBUG_ECHOLNPGM("Rx: ", ev.value ? F("ok") : F("no"));
+        response = ev.value;
+        waitingResponse = false;
+        TERN_(BAFSD_LEARN_SWITCH_TIME, replyTime = millis());
+        break;
+    }
   }
-  return true;
 }
 
 /**
- * Empty the rx buffer
+ * Handle pending input (sensor edges must not be lost) and forget the last reply.
+ * Only BAFSD_RX_BUDGET bytes are taken, so a chatty device can't hold the caller.
  */
 void BAFSD::clear_rx_buffer() {
-  while (BAFSD_SERIAL.available()) BAFSD_SERIAL.read();
-  rx_buffer[0] = '\0';
+  rx_process();
+  dispatch_events();
   response = 99;
 }
 
@@ -21,21 +21,139 @@
  */
 #pragma once
 
+#include "../../libs/circularqueue.h"
+
+#if ENABLED(BAFSD_ODOMETER)
+  #include "../../module/planner.h"
+#endif
+
 #define BAFSD_RX_SIZE  16
 #define BAFSD_TX_SIZE  16
+#define BAFSD_RX_BUDGET         32  // Bytes parsed per bafsd_loop() call
+#define BAFSD_EVENT_QUEUE_SIZE   8
+
+// Parsed input, handed to waiters by bafsd_loop()
+enum BAFSDEventType : uint8_t { BAFSD_EV_REPLY, BAFSD_EV_EDGE };
+struct BAFSDEvent {
+  BAFSDEventType type;
+  uint8_t seq,    // Sequence ID of the request the reply answers
+          value;  // Reply status (0 = no, 1 = ok) or sensor state
+};
+
+/**
+ * Phases of a port swap, advanced one step at a time from bafsd_loop()
+ */
+enum BAFSDPhase : uint8_t {
+  BAFSD_IDLE,               // No swap in progress
+  BAFSD_SELECT,             // First selection, no filament loaded yet
+  #if ENABLED(BAFSD_ODOMETER)
+    BAFSD_LOW_SPOOL,        // Wait for a new spool before swapping to a nearly empty one
+  #endif
+  BAFSD_UNLOAD_TO_SENSOR,   // Retract until the sensor reports no filament
+  BAFSD_RETRACT_TO_GEAR,    // Retract to just before the extruder gear
+  BAFSD_DEVICE_SWITCH,      // Send the port change to the device
+  BAFSD_GRIP_ASSIST,        // Feed to help the gear grip the new filament
+  BAFSD_LOAD_TO_SENSOR,     // Feed until the sensor reports filament
+  BAFSD_RETRY,              // Ask the device for a small feed, then load again
+  BAFSD_USER_RECOVERY       // Park and wait for the user to fix the load
+};
+
+/**
+ * Device commands. Sent as frames when the device speaks the framed
+ * protocol, otherwise as the equivalent ASCII G-code.
+ * See bafsd-serial-protocol.md
+ */
+enum BAFSDOp : uint8_t {
+  BAFSD_OP_HELLO  = 0x01,   // Negotiate framing and baud rate
+  BAFSD_OP_SELECT = 0x02,   // T<port>
+  BAFSD_OP_SENSOR = 0x03,   // M412
+  BAFSD_OP_FEED   = 0x04,   // C<n>
+  BAFSD_OP_CAMERA = 0x05,   // M240 D<ms>
+  BAFSD_OP_RESET  = 0x06,   // M709
+  BAFSD_OP_EVENTS = 0x07,   // M412 E1
+  BAFSD_OP_STAGE  = 0x08,   // P<port>
+  BAFSD_OP_EDGE   = 0x40,   // Device => host, sensor edge
+  BAFSD_OP_REPLY  = 0x80    // Device => host, OR'ed with the request op
+};
+
+#define BAFSD_MAX_INFLIGHT     4    // Requests that may await a reply at once
+
+#if ENABLED(BAFSD_FRAMED_LINK)
+  #define BAFSD_FRAME_SYNC     0xBA
+  #define BAFSD_FRAME_PAYLOAD  4    // Longest payload (HELLO baud rate)
+
+  enum BAFSDLink : uint8_t {
+    BAFSD_LINK_UNKNOWN,     // Not negotiated yet
+    BAFSD_LINK_NEGOTIATE,   // HELLO sent, waiting for the reply
+    BAFSD_LINK_FRAMED,
+    BAFSD_LINK_ASCII        // Older device firmware
+  };
+#endif
+
+#if ENABLED(BAFSD_SENSOR_EVENTS)
+  // Whether the device pushes sensor edges ("F0" / "F1") on its own
+  enum BAFSDEvents : uint8_t {
+    BAFSD_EVENTS_UNKNOWN,
+    BAFSD_EVENTS_PENDING,
+    BAFSD_EVENTS_ON,
+    BAFSD_EVENTS_OFF
+  };
+#endif
 
 class BAFSD {
 public:
   BAFSD();
   static void init();
-  static void select_port(const uint8_t e);
+  static void select_port(uint8_t e);
   static uint8_t current_port();
   static uint8_t next_port();
   static void reset();
   static void trigger_camera(const uint16_t d);
+  static void user_step();
 
   static void bafsd_loop();
 
+  // A port swap is running in the background
+  static bool busy() { return phase != BAFSD_IDLE; }
+  static BAFSDPhase current_phase() { return phase; }
+
+  #if ENABLED(BAFSD_SENSOR_EVENTS)
+    // E position (steps) where the last watched sensor edge was seen
+    static int32_t sensor_edge_steps() { return edgeSteps; }
+  #endif
+
+  #if ENABLED(BAFSD_LEARN_SWITCH_TIME)
+    // Learned switch duration (ms) per from / to port, 0 = not learned yet
+    static uint16_t switch_time[EXTRUDERS][EXTRUDERS];
+    static void reset_switch_times();
+  #endif
+
+  #if ENABLED(BAFSD_ODOMETER)
+    static float spool_mm[EXTRUDERS],   // Filament on the spool when it was loaded, 0 = unknown
+                 used_mm[EXTRUDERS];    // Fed from each port since its spool was loaded
+    static float used(const uint8_t p);
+    static float remaining(const uint8_t p) { return spool_mm[p] - used(p); }
+    static bool spool_low(const uint8_t p);
+    static void new_spool(const uint8_t p, const float mm);
+    static void save_odometer();
+    static void fold_steps(const bool all=true);
+    // The stepper E position was set without stepping. Called with the stepper ISR held.
+    static void e_position_set(const int32_t from, const int32_t to) { countedE += to - from; }
+  #endif
+
+  #if ENABLED(BAFSD_FAILOVER)
+    static int8_t backup[EXTRUDERS];    // Port that takes over when a port is empty, -1 for none
+    static uint8_t emptyPorts;          // Bit per port found empty since the last M714 R
+    static uint8_t route(uint8_t p);
+    static bool runout_failover();
+    static void swap_to_backup();
+    static void reset_backup_ports();
+  #endif
+
+  // Commands that may run while a swap holds the queue
+  static bool passthrough(const char *cmd);
+  static const char* skip_line_number(const char *cmd);
+
 private:
   static uint8_t port;
   static uint8_t nextPort;
@@ -45,19 +163,88 @@ private:
   static bool waitingResponse;
   static char rx_buffer[BAFSD_RX_SIZE], tx_buffer[BAFSD_TX_SIZE];
 
-  static bool rx_str(FSTR_P fstr);
-  static void tx_str(FSTR_P fstr);
-  static void tx_printf(FSTR_P ffmt, const int argument);
-  static void tx_printf(FSTR_P ffmt, const int argument1, const int argument2);
+  static BAFSDPhase phase;
+  static bool stepping, queried, switchOk, retried;
+  static uint8_t attempts;
+  static millis_t holdUntil, phaseExpire;
+
+  static void set_phase(const BAFSDPhase p);
+  static void hold(const millis_t ms) { holdUntil = millis() + ms; }
+  static void swap_step();
+  static void finish_swap();
+  static void move_extruder(const float dist, const feedRate_t fr_mm_s);
+
+  #if ENABLED(BAFSD_SENSOR_EVENTS)
+    static BAFSDEvents events;
+    static bool searching, searchFor, edgeSeen;
+    static int32_t edgeSteps;
+    static bool arm_events();
+    static void start_search(const float dist, const feedRate_t fr_mm_s, const bool present);
+    static void end_search();
+  #endif
+  static void sensor_edge(const bool present);
+
+  #if ENABLED(BAFSD_LOOKAHEAD)
+    static uint8_t aheadPort, stagedPort, stagePort, stageSeq;
+    static bool stagePending;
+    static millis_t stageIssueTime, next_scan_ms;
+    static uint8_t tool_in_line(const char *cmd);
+    static uint8_t look_ahead(const uint8_t e, const bool scan_sd=true);
+    static void stage_next();
+  #endif
+
+  #if ENABLED(BAFSD_ODOMETER)
+    static BAFSDPhase afterCheck;
+    static int32_t fedSteps[EXTRUDERS],           // Stepped per port, not yet folded into used_mm
+                   countedE;                      // Stepper E position already counted
+    static void count_steps();
+    static void autosave_odometer();
+  #endif
+  static void start_swap(const BAFSDPhase p);
+
+  #if ENABLED(BAFSD_FAILOVER)
+    static bool failingOver;
+    static uint8_t fail_over(const uint8_t p);
+  #endif
+
+  #if ENABLED(BAFSD_LEARN_SWITCH_TIME)
+    static bool timeSwitch;
+    static millis_t replyTime;
+    static void learn_switch_time(const uint8_t from, const uint8_t to, const millis_t ms);
+  #endif
+
+  // Every request gets a sequence ID, so a reply is only taken by the request it answers
+  static uint8_t txSeq, waitSeq;
+  struct Inflight { uint8_t seq, op; millis_t expire; };
+  static uint8_t next_seq() { if (++txSeq == 0) txSeq = 1; return txSeq; } // 0 is for unsolicited frames
+
+  static uint8_t command(const BAFSDOp op, const uint32_t arg=0, const int t=BAFSD_TIMEOUT, const bool wait=true);
   static void clear_rx_buffer();
 
-  static bool rx_ok();
-  static bool rx_no();
+  // An ASCII device answers in order, so a reply is for the oldest line sent
+  static CircularQueue<Inflight, BAFSD_MAX_INFLIGHT> sentLines;
+  static uint8_t tx_ascii(const BAFSDOp op, const uint32_t arg, const int t);
+  static void expire_lines();
+
+  #if ENABLED(BAFSD_FRAMED_LINK)
+    static BAFSDLink link;
+    static Inflight inflight[BAFSD_MAX_INFLIGHT];
+    static uint8_t tx_frame(const BAFSDOp op, const uint32_t arg);
+    static void rx_frame_byte(const uint8_t c);
+    static void rx_frame(const uint8_t seq, const uint8_t op, const uint8_t * const data, const uint8_t len);
+    static bool negotiate();
+  #endif
+
+  static uint8_t rx_len;
+  static CircularQueue<BAFSDEvent, BAFSD_EVENT_QUEUE_SIZE> rx_events;
+  static void rx_process();
+  static void rx_line();
+  static void post_event(const BAFSDEventType type, const uint8_t seq, const uint8_t value);
+  static void dispatch_events();
 
-  static void get_response(const int t);
+  static void request(const int t);
+  static void query_sensor();
 
-  static uint8_t load_to_sensor();
-  static uint8_t filament_present();
   static bool too_cold(const uint8_t e);
 };
 
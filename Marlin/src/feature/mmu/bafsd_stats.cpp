@@ -0,0 +1,127 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+#if BOTH(HAS_BAFSD, BAFSD_PROFILE)
+
+#include "bafsd_stats.h"
+
+#if ENABLED(PRINTCOUNTER)
+  #include "../../module/printcounter.h"
+#endif
+
+BAFSDStats bafsd_stats;
+
+bafsd_stat_t BAFSDStats::stats[EXTRUDERS][PHASES + 1];
+millis_t BAFSDStats::phase_start, BAFSDStats::swap_start;
+uint32_t BAFSDStats::swap_ms[PHASES];
+uint8_t BAFSDStats::seen;
+
+AutoReporter<BAFSDStats::AutoReportBAFSD> BAFSDStats::auto_reporter;
+
+void bafsd_stat_t::add(const millis_t ms) {
+  if (count == UINT16_MAX) return;
+  const uint16_t t = _MIN(ms, millis_t(UINT16_MAX));
+  if (!count || t < min_ms) min_ms = t;
+  NOLESS(max_ms, t);
+  count++;
+  total_ms += ms;
+  uint8_t b = 0;
+  for (millis_t edge = 500; b < BAFSD_STAT_BINS - 1 && ms >= edge; edge <<= 1) b++;
+  hist[b]++;
+}
+
+/**
+ * Called on every phase change with the phase being left.
+ * Leaving BAFSD_IDLE starts a new swap.
+ */
+void BAFSDStats::phase_done(const BAFSDPhase p) {
+  const millis_t ms = millis(), dt = ms - phase_start;
+  phase_start = ms;
+  if (p == BAFSD_IDLE) {
+    swap_start = ms;
+    ZERO(swap_ms);
+    seen = 0;
+    return;
+  }
+  if (p < BAFSD_UNLOAD_TO_SENSOR) return; // First selection, not a swap
+  const uint8_t i = p - BAFSD_UNLOAD_TO_SENSOR;
+  swap_ms[i] += dt;
+  SBI(seen, i);
+}
+
+void BAFSDStats::swap_done(const uint8_t port) {
+  if (port >= EXTRUDERS) return;
+  const millis_t total = millis() - swap_start;
+  bafsd_stat_t * const s = stats[port];
+  LOOP_L_N(i, PHASES) if (TEST(seen, i)) s[i].add(swap_ms[i]);
+  s[SWAP].add(total);
+  TERN_(PRINTCOUNTER, print_job_timer.incToolChange(total));
+}
+
+void BAFSDStats::reset() { ZERO(stats); }
+
+static FSTR_P phase_name(const uint8_t i) {
+  switch (i + BAFSD_UNLOAD_TO_SENSOR) {
+    case BAFSD_UNLOAD_TO_SENSOR: return F("Unload");
+    case BAFSD_RETRACT_TO_GEAR:  return F("Retract");
+    case BAFSD_DEVICE_SWITCH:    return F("Switch");
+    case BAFSD_GRIP_ASSIST:      return F("Grip");
+    case BAFSD_LOAD_TO_SENSOR:   return F("Load");
+    case BAFSD_RETRY:            return F("Retry");
+    case BAFSD_USER_RECOVERY:    return F("Recovery");
+    default:                     return F("Swap");
+  }
+}
+
+static void report_stat(FSTR_P const name, const bafsd_stat_t &s, const bool hist) {
+  SERIAL_ECHOF(name);
+  SERIAL_ECHOPGM(" n:", s.count, " avg:", s.avg_ms(), " min:", s.min_ms, " max:", s.max_ms);
+  if (hist) {
+    SERIAL_ECHOPGM(" hist:");
+    LOOP_L_N(b, BAFSD_STAT_BINS) {
+      if (b) SERIAL_CHAR(',');
+      SERIAL_ECHO(s.hist[b]);
+    }
+  }
+  SERIAL_EOL();
+}
+
+/**
+ * Times in ms, per port swapped to. The short report only has the whole swap.
+ */
+void BAFSDStats::report(const bool full/*=true*/) {
+  LOOP_L_N(e, EXTRUDERS) {
+    const bafsd_stat_t * const s = stats[e];
+    if (!s[SWAP].count) continue;
+    SERIAL_ECHOPGM("BAFS T", e, " ");
+    report_stat(phase_name(SWAP), s[SWAP], full);
+    if (full) LOOP_L_N(i, PHASES) {
+      if (!s[i].count) continue;
+      SERIAL_ECHOPGM("  ");
+      report_stat(phase_name(i), s[i], true);
+    }
+  }
+}
+
+#endif // HAS_BAFSD && BAFSD_PROFILE
@@ -0,0 +1,66 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * bafsd_stats.h - Time spent in each phase of a BAFS port swap
+ */
+
+#include "bafsd.h"
+#include "../../libs/autoreport.h"
+
+#define BAFSD_STAT_BINS 6   // Histogram: <0.5s, <1s, <2s, <4s, <8s, longer
+
+typedef struct {
+  uint16_t count,
+           min_ms, max_ms;  // Clamped to 65.5s
+  uint32_t total_ms;
+  uint16_t hist[BAFSD_STAT_BINS];
+
+  void add(const millis_t ms);
+  uint32_t avg_ms() const { return count ? total_ms / count : 0; }
+} bafsd_stat_t;
+
+class BAFSDStats {
+public:
+  // Swap phases from BAFSD_UNLOAD_TO_SENSOR on, then the whole swap
+  static constexpr uint8_t PHASES = BAFSD_USER_RECOVERY - BAFSD_UNLOAD_TO_SENSOR + 1,
+                           SWAP = PHASES;
+
+  // Per port swapped to
+  static bafsd_stat_t stats[EXTRUDERS][PHASES + 1];
+
+  static void phase_done(const BAFSDPhase p);
+  static void swap_done(const uint8_t port);
+  static void reset();
+  static void report(const bool full=true);
+
+  struct AutoReportBAFSD { static void report() { BAFSDStats::report(false); } };
+  static AutoReporter<AutoReportBAFSD> auto_reporter;
+
+private:
+  static millis_t phase_start, swap_start;
+  static uint32_t swap_ms[PHASES];  // Time in each phase of the running swap
+  static uint8_t seen;              // Phases entered during the running swap
+};
+
+extern BAFSDStats bafsd_stats;
@@ -72,10 +72,18 @@ bool FilamentMonitorBase::enabled = true,
   #include "../lcd/e3v2/proui/dwin.h"
 #endif
 
+#if BOTH(HAS_BAFSD, BAFSD_FAILOVER)
+  #include "mmu/bafsd.h"
+#endif
+
 void event_filament_runout(const uint8_t extruder) {
 
   if (did_pause_print) return;  // Action already in progress. Purge triggered repeated runout.
 
+  #if BOTH(HAS_BAFSD, BAFSD_FAILOVER)
+    if (bafsd.runout_failover()) return;  // Swapping to the backup port, no need to pause
+  #endif
+
   #if ENABLED(TOOLCHANGE_MIGRATION_FEATURE)
     if (migration.in_progress) {
       DEBUG_ECHOLNPGM("Migration Already In Progress");
@@ -46,6 +46,10 @@
 
 #include "../../module/probe.h"
 
+#if ENABLED(FT_MOTION)
+  #include "../../module/ft_motion.h"
+#endif
+
 #if ENABLED(BLTOUCH)
   #include "../../feature/bltouch.h"
 #endif
@@ -208,6 +212,9 @@ void GcodeSuite::G28() {
 
   TERN_(BD_SENSOR, bdl.config_state = 0);
 
+  // Homing needs the endstops, which only the trapezoid ISR checks
+  TERN_(FT_MOTION, FTMotionDisableInScope FT_Disabler);
+
   /**
    * Set the laser power to false to stop the planner from processing the current power setting.
    */
@@ -37,6 +37,10 @@
 #include "../../module/endstops.h"
 #include "../../feature/bedlevel/bedlevel.h"
 
+#if ENABLED(FT_MOTION)
+  #include "../../module/ft_motion.h"
+#endif
+
 #if !AXIS_CAN_CALIBRATE(X)
   #undef CALIBRATION_MEASURE_LEFT
   #undef CALIBRATION_MEASURE_RIGHT
@@ -850,6 +854,9 @@ void GcodeSuite::G425() {
 
   if (homing_needed_error()) return;
 
+  // Endstops are only checked by the trapezoid ISR
+  TERN_(FT_MOTION, FTMotionDisableInScope FT_Disabler);
+
   TEMPORARY_BED_LEVELING_STATE(false);
   SET_SOFT_ENDSTOP_LOOSE(true);
 
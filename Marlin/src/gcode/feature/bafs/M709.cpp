@@ -28,10 +28,14 @@
 #include "../../../feature/mmu/bafsd.h"
 
 /**
- * M403: Reset BAFSD
+ * M709: Reset BAFSD
  *
+ *   W - Wait for the user to fix a swap, then go on with it. Queued by the swap.
  */
 void GcodeSuite::M709() {
+  if (parser.seen_test('W'))
+    bafsd.user_step();
+  else
     bafsd.reset();
 }
 
@@ -0,0 +1,68 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../../inc/MarlinConfigPre.h"
+
+#if HAS_BAFSD && ENABLED(BAFSD_LEARN_SWITCH_TIME)
+
+#include "../../gcode.h"
+#include "../../../feature/mmu/bafsd.h"
+
+void GcodeSuite::M711_report(const bool forReplay/*=true*/) {
+  report_heading_etc(forReplay, F("BAFS switch times (ms)"));
+  bool first = true;
+  LOOP_L_N(from, EXTRUDERS) LOOP_L_N(to, EXTRUDERS) {
+    const uint16_t t = bafsd.switch_time[from][to];
+    if (!t) continue;
+    if (!first) report_echo_start(forReplay);
+    first = false;
+    SERIAL_ECHOLNPGM("  M711 P", from, " T", to, " S", t);
+  }
+  if (first) SERIAL_ECHOLNPGM("  ; None learned");  // A comment, so replayed M503 output stays valid G-code
+}
+
+/**
+ * M711: Report, set or reset the learned BAFS switch times
+ *
+ *  R            Forget all learned times
+ *  P<port>      Port switched from
+ *  T<port>      Port switched to
+ *  S<ms>        Time from the select command to the device's reply. 0 to forget.
+ *
+ * Use M500 to keep the table across restarts.
+ */
+void GcodeSuite::M711() {
+  if (!parser.seen_any()) return M711_report();
+
+  if (parser.seen_test('R')) bafsd.reset_switch_times();
+
+  if (parser.seenval('S')) {
+    const uint16_t t = parser.value_ushort();
+    const uint8_t from = parser.byteval('P', EXTRUDERS), to = parser.byteval('T', EXTRUDERS);
+    if (from < EXTRUDERS && to < EXTRUDERS && from != to)
+      bafsd.switch_time[from][to] = t;
+    else
+      SERIAL_ECHO_MSG("?Ports (P, T) must differ and be 0-", EXTRUDERS - 1);
+  }
+}
+
+#endif
@@ -0,0 +1,49 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../../inc/MarlinConfig.h"
+
+#if HAS_BAFSD && ENABLED(BAFSD_PROFILE)
+
+#include "../../gcode.h"
+#include "../../../feature/mmu/bafsd_stats.h"
+
+/**
+ * M712: Report BAFS swap statistics
+ *
+ * Per port swapped to: count, avg / min / max time (ms) and a histogram
+ * (<0.5s, <1s, <2s, <4s, <8s, longer) of the whole swap and of each phase.
+ * Lifetime totals are in M78.
+ *
+ *  R            Reset the statistics
+ *  S<seconds>   Auto-report interval for the swap times, 0 to stop
+ */
+void GcodeSuite::M712() {
+  if (parser.seen_test('R')) bafsd_stats.reset();
+
+  if (parser.seenval('S'))
+    bafsd_stats.auto_reporter.set_interval(parser.value_byte());
+
+  if (!parser.seen_any()) bafsd_stats.report();
+}
+
+#endif
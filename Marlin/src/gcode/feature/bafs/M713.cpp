@@ -0,0 +1,73 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../../inc/MarlinConfigPre.h"
+
+#if HAS_BAFSD && ENABLED(BAFSD_ODOMETER)
+
+#include "../../gcode.h"
+#include "../../../feature/mmu/bafsd.h"
+
+void GcodeSuite::M713_report(const bool forReplay/*=true*/) {
+  report_heading_etc(forReplay, F("BAFS spool length / filament used (mm)"));
+  LOOP_L_N(p, EXTRUDERS) {
+    if (p) report_echo_start(forReplay);
+    SERIAL_ECHOPGM("  M713 P", p, " S", bafsd.spool_mm[p], " U", bafsd.used(p));
+    if (!forReplay && bafsd.spool_mm[p]) SERIAL_ECHOPGM(" ; ", bafsd.remaining(p), " left");
+    SERIAL_EOL();
+  }
+}
+
+/**
+ * M713: Report or set the filament used from each BAFS port
+ *
+ *  R            Clear the filament used on all ports
+ *  P<port>      Port to set
+ *  S<mm>        A new spool of this length was loaded. Clears the filament used. 0 = unknown length.
+ *  U<mm>        Filament used from the spool
+ *
+ * With a known spool length the printer pauses before swapping to a port
+ * with less than BAFSD_LOW_SPOOL_MM left. The counts are saved when set here,
+ * at the end of each print and every BAFSD_ODOMETER_SAVE_INTERVAL minutes.
+ */
+void GcodeSuite::M713() {
+  if (!parser.seen("RSU")) return M713_report(false);
+
+  if (parser.seen_test('R')) LOOP_L_N(p, EXTRUDERS) bafsd.new_spool(p, bafsd.spool_mm[p]);
+
+  if (parser.seen("SU")) {
+    const uint8_t p = parser.byteval('P', EXTRUDERS);
+    if (p >= EXTRUDERS) {
+      SERIAL_ECHO_MSG("?Port (P) must be 0-", EXTRUDERS - 1);
+      return;
+    }
+    if (parser.seenval('S')) bafsd.new_spool(p, _MAX(parser.value_linear_units(), 0.0f));
+    if (parser.seenval('U')) {
+      bafsd.fold_steps();
+      bafsd.used_mm[p] = parser.value_linear_units();
+    }
+  }
+
+  bafsd.save_odometer();
+}
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../../inc/MarlinConfigPre.h"
+
+#if HAS_BAFSD && ENABLED(BAFSD_FAILOVER)
+
+#include "../../gcode.h"
+#include "../../../feature/mmu/bafsd.h"
+
+void GcodeSuite::M714_report(const bool forReplay/*=true*/) {
+  report_heading_etc(forReplay, F("BAFS backup ports"));
+  LOOP_L_N(p, EXTRUDERS) {
+    if (p) report_echo_start(forReplay);
+    SERIAL_ECHOPGM("  M714 P", p, " B", bafsd.backup[p]);
+    if (!forReplay && TEST(bafsd.emptyPorts, p)) SERIAL_ECHOPGM(" ; empty, using ", bafsd.route(p));
+    SERIAL_EOL();
+  }
+}
+
+/**
+ * M714: Report or set the BAFS backup ports
+ *
+ *  P<port>      Port to set
+ *  B<port>      Port that takes over when this one runs out or won't load. -1 for none.
+ *  R            Spools were refilled. Go back to the ports asked for.
+ *  F            Swap to the backup of a port that ran out. Queued on a runout.
+ *
+ * Use M500 to keep the table across restarts.
+ */
+void GcodeSuite::M714() {
+  if (parser.seen_test('F')) return bafsd.swap_to_backup();
+
+  if (!parser.seen("BR")) return M714_report(false);
+
+  if (parser.seen_test('R')) bafsd.emptyPorts = 0;
+
+  if (parser.seenval('B')) {
+    const int8_t b = parser.value_int();
+    const uint8_t p = parser.byteval('P', EXTRUDERS);
+    if (p < EXTRUDERS && WITHIN(b, -1, EXTRUDERS - 1) && b != p)
+      bafsd.backup[p] = b;
+    else
+      SERIAL_ECHO_MSG("?Ports (P, B) must differ and be 0-", EXTRUDERS - 1);
+  }
+}
+
+#endif
@@ -0,0 +1,51 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2023 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../../inc/MarlinConfig.h"
+
+#if ENABLED(FT_MOTION)
+
+#include "../../gcode.h"
+#include "../../../module/ft_motion.h"
+
+void GcodeSuite::M493_report(const bool forReplay/*=true*/) {
+  report_heading_etc(forReplay, F("Fixed-Time Motion"));
+  SERIAL_ECHOPGM("  M493 S", FTMotion::active);
+  if (!forReplay) SERIAL_ECHOPGM(" ; ", FTMotion::underruns, " underruns");
+  SERIAL_EOL();
+}
+
+/**
+ * M493: Report or switch fixed-time motion
+ *
+ *  S<bool>      1 to sample moves at a fixed time step, 0 to use the trapezoid ISR.
+ *  R            Reset the count of times the step buffer ran dry mid-move.
+ *
+ * Waits for all moves to finish before switching.
+ */
+void GcodeSuite::M493() {
+  if (!parser.seen("RS")) return M493_report(false);
+  if (parser.seen_test('R')) FTMotion::underruns = 0;
+  if (parser.seen('S')) ftMotion.set_active(parser.value_bool());
+}
+
+#endif // FT_MOTION
@@ -29,57 +29,83 @@
 
 void GcodeSuite::M593_report(const bool forReplay/*=true*/) {
   report_heading_etc(forReplay, F("Input Shaping"));
-  #if ENABLED(INPUT_SHAPING_X)
-    SERIAL_ECHOLNPGM("  M593 X"
-      " F", stepper.get_shaping_frequency(X_AXIS),
-      " D", stepper.get_shaping_damping_ratio(X_AXIS)
+  LOOP_L_N(a, NUM_SHAPED_AXES) {
+    const AxisEnum axis = shaped_axis[a];
+    if (a) report_echo_start(forReplay);
+    SERIAL_ECHOLNPGM("  M593 ", AS_CHAR(AXIS_CHAR(axis)),
+      " F", stepper.get_shaping_frequency(axis),
+      " D", stepper.get_shaping_damping_ratio(axis),
+      " T", stepper.get_shaping_type(axis)
     );
-  #endif
-  #if ENABLED(INPUT_SHAPING_Y)
-    TERN_(INPUT_SHAPING_X, report_echo_start(forReplay));
-    SERIAL_ECHOLNPGM("  M593 Y"
-      " F", stepper.get_shaping_frequency(Y_AXIS),
-      " D", stepper.get_shaping_damping_ratio(Y_AXIS)
-    );
-  #endif
+  }
 }
 
 /**
  * M593: Get or Set Input Shaping Parameters
  *  D<factor>    Set the zeta/damping factor. If axes (X, Y, etc.) are not specified, set for all axes.
  *  F<frequency> Set the frequency. If axes (X, Y, etc.) are not specified, set for all axes.
- *  T[map]       Input Shaping type, 0:ZV, 1:EI, 2:2H EI (not implemented yet)
+ *  T<type>      Set the shaper type. 0:ZV, 1:EI, 2:2HEI, 3:ZVD, 4:MZV
+ *               Types with more than SHAPING_MAX_IMPULSES impulses are not available.
+ *               A type and frequency whose last echo would overrun the shaping timer are rejected.
  *  X            Set the given parameters only for the X axis.
  *  Y            Set the given parameters only for the Y axis.
+ *  Z            Set the given parameters only for the Z axis.
+ *  E            Set the given parameters only for the E axis.
  */
 void GcodeSuite::M593() {
   if (!parser.seen_any()) return M593_report();
 
-  const bool seen_X = TERN0(INPUT_SHAPING_X, parser.seen_test('X')),
-             seen_Y = TERN0(INPUT_SHAPING_Y, parser.seen_test('Y')),
-             for_X = seen_X || TERN0(INPUT_SHAPING_X, (!seen_X && !seen_Y)),
-             for_Y = seen_Y || TERN0(INPUT_SHAPING_Y, (!seen_X && !seen_Y));
+  // The shaped axes named in the command, or all of them
+  bool for_axis[NUM_SHAPED_AXES], seen_axis = false;
+  LOOP_L_N(a, NUM_SHAPED_AXES) seen_axis |= (for_axis[a] = parser.seen_test(AXIS_CHAR(shaped_axis[a])));
+  if (!seen_axis) LOOP_L_N(a, NUM_SHAPED_AXES) for_axis[a] = true;
+
+  // The last echo of the shaper must fit the shaping timer
+  auto min_freq = [](const ShaperType t) { return float(uint32_t(STEPPER_TIMER_RATE) / 8) * shaper_span(t) / shaping_time_t(-2); };
+
+  ShaperType type = NUM_SHAPERS; // No new type
+  if (parser.seenval('T')) {
+    const ShaperType t = ShaperType(parser.value_byte());
+    if (t < NUM_SHAPERS && shaper_impulses(t) <= SHAPING_MAX_IMPULSES)
+      type = t;
+    else
+      SERIAL_ECHO_MSG("?Type (T) not available with SHAPING_MAX_IMPULSES ", SHAPING_MAX_IMPULSES);
+  }
 
   if (parser.seen('D')) {
     const float zeta = parser.value_float();
     if (WITHIN(zeta, 0, 1)) {
-      if (for_X) stepper.set_shaping_damping_ratio(X_AXIS, zeta);
-      if (for_Y) stepper.set_shaping_damping_ratio(Y_AXIS, zeta);
+      LOOP_L_N(a, NUM_SHAPED_AXES) if (for_axis[a]) stepper.set_shaping_damping_ratio(shaped_axis[a], zeta);
     }
     else
       SERIAL_ECHO_MSG("?Zeta (D) value out of range (0-1)");
   }
 
-  if (parser.seen('F')) {
-    const float freq = parser.value_float();
-    constexpr float min_freq = float(uint32_t(STEPPER_TIMER_RATE) / 2) / shaping_time_t(-2);
-    if (freq == 0.0f || freq > min_freq) {
-      if (for_X) stepper.set_shaping_frequency(X_AXIS, freq);
-      if (for_Y) stepper.set_shaping_frequency(Y_AXIS, freq);
-    }
+  const bool seen_freq = parser.seen('F');
+  const float freq = seen_freq ? parser.value_float() : 0.0f;
+
+  // A new type is checked against the frequency it will run at, and a new frequency against the type
+  float min_f = 0.0f;
+  bool fits = true;
+  LOOP_L_N(a, NUM_SHAPED_AXES) if (for_axis[a]) {
+    const AxisEnum axis = shaped_axis[a];
+    const float mf = min_freq(type < NUM_SHAPERS ? type : stepper.get_shaping_type(axis)),
+                f = seen_freq ? freq : stepper.get_shaping_frequency(axis);
+    NOLESS(min_f, mf);
+    if (f != 0.0f && f <= mf) fits = false;
+  }
+  if (!fits) {
+    if (seen_freq)
+      SERIAL_ECHOLNPGM("?Frequency (F) must be greater than ", min_f, " or 0 to disable");
     else
-      SERIAL_ECHOLNPGM("?Frequency (F) must be greater than ", min_freq, " or 0 to disable");
+      SERIAL_ECHOLNPGM("?Type (T) needs a frequency (F) greater than ", min_f);
+    return;
   }
+
+  if (type < NUM_SHAPERS)
+    LOOP_L_N(a, NUM_SHAPED_AXES) if (for_axis[a]) stepper.set_shaping_type(shaped_axis[a], type);
+  if (seen_freq)
+    LOOP_L_N(a, NUM_SHAPED_AXES) if (for_axis[a]) stepper.set_shaping_frequency(shaped_axis[a], freq);
 }
 
 #endif
@@ -0,0 +1,50 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2023 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "../../../inc/MarlinConfig.h"
+
+#if ENABLED(STEPPER_ISR_PROFILE)
+
+#include "../../gcode.h"
+#include "../../../module/stepper/isr_profile.h"
+
+/**
+ * M494: Report stepper ISR timing
+ *
+ * The share of time spent in the stepper ISR and the ISR overruns since
+ * the last reset, then count, avg / min / max time of each ISR phase.
+ * Times are in CPU cycles, or in ns on the native simulator.
+ *
+ *  R            Reset the statistics
+ *  S<seconds>   Auto-report interval for the load and the whole ISR, 0 to stop
+ */
+void GcodeSuite::M494() {
+  if (parser.seen_test('R')) isr_profile.reset();
+
+  if (parser.seenval('S'))
+    isr_profile.auto_reporter.set_interval(parser.value_byte());
+
+  if (!parser.seen_any()) isr_profile.report();
+}
+
+#endif
@@ -854,6 +854,18 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
 
       #if HAS_BAFSD
         case 709: M709(); break;
+        #if ENABLED(BAFSD_LEARN_SWITCH_TIME)
+          case 711: M711(); break;                                // M711: Report, set or reset BAFS switch times
+        #endif
+        #if ENABLED(BAFSD_PROFILE)
+          case 712: M712(); break;                                // M712: Report BAFS swap statistics
+        #endif
+        #if ENABLED(BAFSD_ODOMETER)
+          case 713: M713(); break;                                // M713: Report or set BAFS filament used
+        #endif
+        #if ENABLED(BAFSD_FAILOVER)
+          case 714: M714(); break;                                // M714: Report or set BAFS backup ports
+        #endif
       #endif
 
       #if ENABLED(FILAMENT_WIDTH_SENSOR)
@@ -899,6 +911,14 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
         case 486: M486(); break;                                  // M486: Identify and cancel objects
       #endif
 
+      #if ENABLED(FT_MOTION)
+        case 493: M493(); break;                                  // M493: Report or switch fixed-time motion
+      #endif
+
+      #if ENABLED(STEPPER_ISR_PROFILE)
+        case 494: M494(); break;                                  // M494: Report stepper ISR timing
+      #endif
+
       case 500: M500(); break;                                    // M500: Store settings in EEPROM
       case 501: M501(); break;                                    // M501: Read settings from EEPROM
       case 502: M502(); break;                                    // M502: Revert to default settings
@@ -244,6 +244,8 @@
  * M428 - Set the home_offset based on the current_position. Nearest edge applies. (Disabled by NO_WORKSPACE_OFFSETS or DELTA)
  * M430 - Read the system current, voltage, and power (Requires POWER_MONITOR_CURRENT, POWER_MONITOR_VOLTAGE, or POWER_MONITOR_FIXED_VOLTAGE)
  * M486 - Identify and cancel objects. (Requires CANCEL_OBJECTS)
+ * M493 - Report or switch fixed-time motion. (Requires FT_MOTION)
+ * M494 - Report or reset stepper ISR timing, set the auto-report interval. (Requires STEPPER_ISR_PROFILE)
  * M500 - Store parameters in EEPROM. (Requires EEPROM_SETTINGS)
  * M501 - Restore parameters from EEPROM. (Requires EEPROM_SETTINGS)
  * M502 - Revert to the default "factory settings". ** Does not write them to EEPROM! **
@@ -270,7 +272,11 @@
  * M672 - Set/Reset Duet Smart Effector's sensitivity. (Requires DUET_SMART_EFFECTOR and SMART_EFFECTOR_MOD_PIN)
  * M701 - Load filament (Requires FILAMENT_LOAD_UNLOAD_GCODES)
  * M702 - Unload filament (Requires FILAMENT_LOAD_UNLOAD_GCODES)
- * M709 - Reset BAFSD
+ * M709 - Reset BAFSD. W to wait for the user during a swap.
+ * M711 - Report, set or reset the learned BAFS switch times. (Requires BAFSD_LEARN_SWITCH_TIME)
+ * M712 - Report or reset BAFS swap statistics, set the auto-report interval. (Requires BAFSD_PROFILE)
+ * M713 - Report or set the filament used and the spool length of BAFS ports. (Requires BAFSD_ODOMETER)
+ * M714 - Report or set the BAFS backup ports. (Requires BAFSD_FAILOVER)
  * M808 - Set or Goto a Repeat Marker (Requires GCODE_REPEAT_MARKERS)
  * M810-M819 - Define/execute a G-code macro (Requires GCODE_MACROS)
  * M851 - Set Z probe's XYZ offsets in current units. (Negative values: X=left, Y=front, Z=below)
@@ -998,6 +1004,21 @@ private:
 
   #if HAS_BAFSD
     static void M709();
+    #if ENABLED(BAFSD_LEARN_SWITCH_TIME)
+      static void M711();
+      static void M711_report(const bool forReplay=true);
+    #endif
+    #if ENABLED(BAFSD_PROFILE)
+      static void M712();
+    #endif
+    #if ENABLED(BAFSD_ODOMETER)
+      static void M713();
+      static void M713_report(const bool forReplay=true);
+    #endif
+    #if ENABLED(BAFSD_FAILOVER)
+      static void M714();
+      static void M714_report(const bool forReplay=true);
+    #endif
   #endif
 
   #if ENABLED(FILAMENT_WIDTH_SENSOR)
@@ -1040,6 +1061,15 @@ private:
     static void M486();
   #endif
 
+  #if ENABLED(FT_MOTION)
+    static void M493();
+    static void M493_report(const bool forReplay=true);
+  #endif
+
+  #if ENABLED(STEPPER_ISR_PROFILE)
+    static void M494();
+  #endif
+
   static void M500();
   static void M501();
   static void M502();
@@ -29,6 +29,10 @@
 #include "../../module/planner.h"
 #include "../../module/temperature.h"
 
+#if ENABLED(ARC_NATIVE_BLOCKS)
+  #include "../../module/ft_motion.h"
+#endif
+
 #if ENABLED(DELTA)
   #include "../../module/delta.h"
 #elif ENABLED(SCARA)
@@ -54,6 +58,7 @@
 /**
  * Plan an arc in 2 dimensions, with linear motion in the other axes.
  * The arc is traced with many small linear segments according to the configuration.
+ * With ARC_NATIVE_BLOCKS and fixed-time motion the arc is a single block traced by the stepper.
  */
 void plan_arc(
   const xyze_pos_t &cart,   // Destination position
@@ -197,6 +202,37 @@ void plan_arc(
   // Feedrate for the move, scaled by the feedrate multiplier
   const feedRate_t scaled_fr_mm_s = MMS_SCALED(feedrate_mm_s);
 
+  #if ENABLED(ARC_NATIVE_BLOCKS)
+    // Plan the whole arc as one block when nothing needs the path in segments
+    if (ftMotion.active && !TERN0(HAS_LEVELING, planner.leveling_active)) {
+      // The circle must be within the soft endstops, since the block can't be clipped
+      xyze_pos_t lo = cart, hi = cart;
+      lo[axis_p] = center_P - radius; lo[axis_q] = center_Q - radius;
+      hi[axis_p] = center_P + radius; hi[axis_q] = center_Q + radius;
+      const xyze_pos_t lo_in = lo, hi_in = hi;
+      apply_motion_limits(lo);
+      apply_motion_limits(hi);
+      if (lo == lo_in && hi == hi_in) {
+        const PlannerHints::arc_hint_t arc = { axis_p, axis_q, rvec, angular_travel };
+        PlannerHints hints(HYPOT(flat_mm, TERN0(HAS_Z_AXIS, travel_L)));
+        hints.arc = &arc;
+
+        // Keep the speed in the plane within the axis limits and the centripetal acceleration within the axis accelerations.
+        // The planner limits the feedrate on the block's net motion, which may be none at all for a circle.
+        const float limiting_accel = _MIN(planner.settings.max_acceleration_mm_per_s2[axis_p], planner.settings.max_acceleration_mm_per_s2[axis_q]),
+                    limiting_speed = _MIN(planner.settings.max_feedrate_mm_s[axis_p], planner.settings.max_feedrate_mm_s[axis_q]),
+                    plane_fr_mm_s = _MIN(limiting_speed, SQRT(limiting_accel * radius));
+
+        // The planner divides the feedrate over the whole length of the move, so a helix runs at F along its length
+        xyze_pos_t raw = cart;
+        apply_motion_limits(raw);
+        planner.buffer_line(raw, _MIN(scaled_fr_mm_s, plane_fr_mm_s * hints.millimeters / flat_mm), active_extruder, hints);
+        current_position = raw;
+        return;
+      }
+    }
+  #endif
+
   // Get the ideal segment length for the move based on settings
   const float ideal_segment_mm = (
     #if ARC_SEGMENTS_PER_SEC  // Length based on segments per second and feedrate
@@ -57,6 +57,10 @@ GCodeQueue queue;
   #include "../feature/repeat.h"
 #endif
 
+#if HAS_BAFSD
+  #include "../feature/mmu/bafsd.h"
+#endif
+
 // Frequently used G-code strings
 PGMSTR(G28_STR, "G28");
 
@@ -122,6 +126,34 @@ bool GCodeQueue::RingBuffer::enqueue(const char *cmd, bool skip_ok/*=true*/
   return true;
 }
 
+#if HAS_BAFSD
+
+  /**
+   * Move the first queued command that passes the test to the read position,
+   * keeping the others in order. Return false if none passes. Only commands
+   * a host waits on are moved, so SD file order (and its sdpos) is kept.
+   */
+  bool GCodeQueue::RingBuffer::pull_forward(bool (*test)(const char *cmd)) {
+    for (uint8_t i = 0, r = index_r; i < length; ++i) {
+      if ((r == index_r || !commands[r].skip_ok) && test(commands[r].buffer)) {
+        if (r != index_r) {
+          const CommandLine found = commands[r];
+          for (uint8_t p = r; p != index_r;) {
+            const uint8_t q = p ? p - 1 : BUFSIZE - 1;
+            commands[p] = commands[q];
+            p = q;
+          }
+          commands[index_r] = found;
+        }
+        return true;
+      }
+      if (++r >= BUFSIZE) r = 0;
+    }
+    return false;
+  }
+
+#endif
+
 /**
  * Enqueue with Serial Echo
  * Return true if the command was consumed
@@ -641,6 +673,18 @@ void GCodeQueue::advance() {
     return;
   }
 
+  #if HAS_BAFSD
+    // Hold queued commands while a BAFS port swap runs, except status queries
+    // which are taken from anywhere in the queue so a held move can't block them
+    if (bafsd.busy() && !ring_buffer.pull_forward(bafsd.passthrough)) {
+      #if ENABLED(HOST_KEEPALIVE_FEATURE)
+        KEEPALIVE_STATE(IN_PROCESS);
+        gcode.host_keepalive();
+      #endif
+      return;
+    }
+  #endif
+
   #if ENABLED(BUFFER_MONITORING)
     if (command_buffer_empty) {
       command_buffer_empty = false;
@@ -98,6 +98,10 @@ public:
     inline CommandLine& peek_next_command() { return commands[index_r]; }
 
     inline char* peek_next_command_string() { return peek_next_command().buffer; }
+
+    #if HAS_BAFSD
+      bool pull_forward(bool (*test)(const char *cmd));
+    #endif
   };
 
   /**
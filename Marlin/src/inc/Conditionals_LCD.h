@@ -660,6 +660,10 @@
   #define E_STEPPERS      1
   #define E_MANUAL        1
 
+  #ifndef BAFSD_RX_BUFFER_SIZE
+    #define BAFSD_RX_BUFFER_SIZE 32
+  #endif
+
 #endif
 
 // No inactive extruders with SWITCHING_NOZZLE or Průša MMU1
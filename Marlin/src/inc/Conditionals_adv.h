@@ -92,10 +92,14 @@
   #undef ARC_SUPPORT
   #undef INPUT_SHAPING_Y
   #undef SHAPING_FREQ_Y
+  #undef SHAPING_TYPE_Y
   #undef SHAPING_BUFFER_Y
 #endif
 #if !HAS_Z_AXIS
   #undef SAFE_BED_LEVELING_START_Z
+  #undef INPUT_SHAPING_Z
+  #undef SHAPING_FREQ_Z
+  #undef SHAPING_TYPE_Z
 #endif
 #if !HAS_I_AXIS
   #undef SAFE_BED_LEVELING_START_I
@@ -133,6 +137,7 @@
   #undef LCD_SHOW_E_TOTAL
   #undef MANUAL_E_MOVES_RELATIVE
   #undef STEALTHCHOP_E
+  #undef INPUT_SHAPING_E
 #endif
 
 #if HOTENDS <= 7
@@ -1027,6 +1032,16 @@
   #endif
 #endif
 
+// Planning records for all blocks by default
+#ifndef BLOCK_PLAN_SIZE
+  #define BLOCK_PLAN_SIZE BLOCK_BUFFER_SIZE
+#endif
+
+// S-Curve ramps precomputed by the planner
+#if ENABLED(S_CURVE_ACCELERATION) && defined(S_CURVE_RAMP_PIECES)
+  #define HAS_RAMP_TABLE 1
+#endif
+
 #if ENABLED(DIRECT_STEPPING)
   #ifndef STEPPER_PAGES
     #define STEPPER_PAGES 16
@@ -1197,6 +1212,21 @@
 #endif
 
 // Input shaping
-#if EITHER(INPUT_SHAPING_X, INPUT_SHAPING_Y)
+#if ANY(INPUT_SHAPING_X, INPUT_SHAPING_Y, INPUT_SHAPING_Z, INPUT_SHAPING_E)
   #define HAS_SHAPING 1
+  #ifndef SHAPING_MAX_IMPULSES
+    #define SHAPING_MAX_IMPULSES 2
+  #endif
+  #if ENABLED(INPUT_SHAPING_X) && !defined(SHAPING_TYPE_X)
+    #define SHAPING_TYPE_X ZV
+  #endif
+  #if ENABLED(INPUT_SHAPING_Y) && !defined(SHAPING_TYPE_Y)
+    #define SHAPING_TYPE_Y ZV
+  #endif
+  #if ENABLED(INPUT_SHAPING_Z) && !defined(SHAPING_TYPE_Z)
+    #define SHAPING_TYPE_Z ZV
+  #endif
+  #if ENABLED(INPUT_SHAPING_E) && !defined(SHAPING_TYPE_E)
+    #define SHAPING_TYPE_E ZV
+  #endif
 #endif
@@ -1508,6 +1508,14 @@ static_assert(X_MAX_LENGTH >= X_BED_SIZE, "Movement bounds (X_MIN_POS, X_MAX_POS
   #error "Only enable PIDTEMP or MPCTEMP, but not both."
 #endif
 
+#if ENABLED(MPC_FLOW_FEEDFORWARD)
+  #if DISABLED(MPCTEMP)
+    #error "MPC_FLOW_FEEDFORWARD requires MPCTEMP."
+  #else
+    static_assert(MPC_FLOW_LOOKAHEAD > 0, "MPC_FLOW_LOOKAHEAD must be greater than 0.");
+  #endif
+#endif
+
 #if ENABLED(MPC_INCLUDE_FAN)
   #if FAN_COUNT < 1
     #error "MPC_INCLUDE_FAN requires at least one fan."
@@ -3238,6 +3246,9 @@ static_assert(X_MAX_LENGTH >= X_BED_SIZE, "Movement bounds (X_MIN_POS, X_MAX_POS
   #elif defined(LCD_SERIAL_PORT) && BAFSD_SERIAL_PORT == LCD_SERIAL_PORT
     #error "BAFSD_SERIAL_PORT cannot be the same as LCD_SERIAL_PORT."
   #endif
+  #if BAFSD_RX_BUFFER_SIZE < 2 || !IS_POWER_OF_2(BAFSD_RX_BUFFER_SIZE)
+    #error "BAFSD_RX_BUFFER_SIZE must be a power of 2 greater than 1."
+  #endif
 #endif
 
 /**
@@ -3864,6 +3875,39 @@ static_assert(_PLUS_TEST(4), "HOMING_FEEDRATE_MM_M values must be positive.");
   #error "BLOCK_BUFFER_SIZE must be a power of 2."
 #elif BLOCK_BUFFER_SIZE > 64
   #error "A very large BLOCK_BUFFER_SIZE is not needed and takes longer to drain the buffer on pause / cancel."
+#elif !IS_POWER_OF_2(BLOCK_PLAN_SIZE) || BLOCK_PLAN_SIZE > BLOCK_BUFFER_SIZE
+  #error "BLOCK_PLAN_SIZE must be a power of 2 no larger than BLOCK_BUFFER_SIZE."
+#elif BLOCK_PLAN_SIZE < 8
+  #error "BLOCK_PLAN_SIZE must be 8 or more."
+#endif
+
+#ifdef S_CURVE_RAMP_PIECES
+  #if DISABLED(S_CURVE_ACCELERATION)
+    #error "S_CURVE_RAMP_PIECES requires S_CURVE_ACCELERATION."
+  #elif !WITHIN(S_CURVE_RAMP_PIECES, 4, 16)
+    #error "S_CURVE_RAMP_PIECES must be from 4 to 16."
+  #endif
+#endif
+
+#if ENABLED(COALESCE_SEGMENTS)
+  #if IS_SCARA
+    #error "COALESCE_SEGMENTS is not compatible with SCARA kinematics."
+  #elif !WITHIN(COALESCE_MAX_SEGMENTS, 2, 64)
+    #error "COALESCE_MAX_SEGMENTS must be from 2 to 64."
+  #endif
+#endif
+
+#if ENABLED(THERMISTOR_TABLE_INDEX) && !WITHIN(THERMISTOR_INDEX_BITS, 4, 8)
+  #error "THERMISTOR_INDEX_BITS must be from 4 to 8."
+#endif
+
+#if ENABLED(JD_CORNER_BLENDING)
+  #if !HAS_Z_AXIS
+    #error "JD_CORNER_BLENDING requires X, Y, and Z axes."
+  #elif !WITHIN(JD_BLENDING_SEGMENTS, 3, 8)
+    #error "JD_BLENDING_SEGMENTS must be from 3 to 8."
+  #endif
+  static_assert(JD_BLENDING_TOLERANCE > 0, "JD_BLENDING_TOLERANCE must be greater than 0.");
 #endif
 
 #if ENABLED(LED_CONTROL_MENU) && NONE(HAS_MARLINUI_MENU, DWIN_LCD_PROUI)
@@ -4371,6 +4415,12 @@ static_assert(_PLUS_TEST(4), "HOMING_FEEDRATE_MM_M values must be positive.");
     #error "INPUT_SHAPING_X is not supported with COREXZ."
   #elif BOTH(INPUT_SHAPING_Y, CORE_IS_YZ)
     #error "INPUT_SHAPING_Y is not supported with COREYZ."
+  #elif ENABLED(INPUT_SHAPING_Z) && EITHER(CORE_IS_XZ, CORE_IS_YZ)
+    #error "INPUT_SHAPING_Z is not supported with COREXZ or COREYZ."
+  #elif BOTH(INPUT_SHAPING_E, LIN_ADVANCE)
+    #error "INPUT_SHAPING_E is not compatible with LIN_ADVANCE."
+  #elif BOTH(INPUT_SHAPING_E, MIXING_EXTRUDER)
+    #error "INPUT_SHAPING_E is not compatible with MIXING_EXTRUDER."
   #elif ANY(CORE_IS_XY, MARKFORGED_XY, MARKFORGED_YX)
     #if !BOTH(INPUT_SHAPING_X, INPUT_SHAPING_Y)
       #error "INPUT_SHAPING_X and INPUT_SHAPING_Y must both be enabled for COREXY, COREYX, or MARKFORGED_*."
@@ -4380,11 +4430,15 @@ static_assert(_PLUS_TEST(4), "HOMING_FEEDRATE_MM_M values must be positive.");
     #endif
   #endif
 
+  static_assert(WITHIN(SHAPING_MAX_IMPULSES, 2, 4), "SHAPING_MAX_IMPULSES must be 2, 3 or 4.");
+
   #ifdef SHAPING_MIN_FREQ
     static_assert((SHAPING_MIN_FREQ) > 0, "SHAPING_MIN_FREQ must be > 0.");
   #else
     TERN_(INPUT_SHAPING_X, static_assert((SHAPING_FREQ_X) > 0, "SHAPING_FREQ_X must be > 0 or SHAPING_MIN_FREQ must be set."));
     TERN_(INPUT_SHAPING_Y, static_assert((SHAPING_FREQ_Y) > 0, "SHAPING_FREQ_Y must be > 0 or SHAPING_MIN_FREQ must be set."));
+    TERN_(INPUT_SHAPING_Z, static_assert((SHAPING_FREQ_Z) > 0, "SHAPING_FREQ_Z must be > 0 or SHAPING_MIN_FREQ must be set."));
+    TERN_(INPUT_SHAPING_E, static_assert((SHAPING_FREQ_E) > 0, "SHAPING_FREQ_E must be > 0 or SHAPING_MIN_FREQ must be set."));
   #endif
   #ifdef __AVR__
     #if ENABLED(INPUT_SHAPING_X)
@@ -4401,6 +4455,68 @@ static_assert(_PLUS_TEST(4), "HOMING_FEEDRATE_MM_M values must be positive.");
         static_assert((SHAPING_FREQ_Y) == 0 || (SHAPING_FREQ_Y) * 2 * 0x10000 >= (STEPPER_TIMER_RATE), "SHAPING_FREQ_Y is below the minimum (16) for AVR 16MHz.");
       #endif
     #endif
+    #if ENABLED(INPUT_SHAPING_Z)
+      #if F_CPU > 16000000
+        static_assert((SHAPING_FREQ_Z) == 0 || (SHAPING_FREQ_Z) * 2 * 0x10000 >= (STEPPER_TIMER_RATE), "SHAPING_FREQ_Z is below the minimum (20) for AVR 20MHz.");
+      #else
+        static_assert((SHAPING_FREQ_Z) == 0 || (SHAPING_FREQ_Z) * 2 * 0x10000 >= (STEPPER_TIMER_RATE), "SHAPING_FREQ_Z is below the minimum (16) for AVR 16MHz.");
+      #endif
+    #endif
+    #if ENABLED(INPUT_SHAPING_E)
+      #if F_CPU > 16000000
+        static_assert((SHAPING_FREQ_E) == 0 || (SHAPING_FREQ_E) * 2 * 0x10000 >= (STEPPER_TIMER_RATE), "SHAPING_FREQ_E is below the minimum (20) for AVR 20MHz.");
+      #else
+        static_assert((SHAPING_FREQ_E) == 0 || (SHAPING_FREQ_E) * 2 * 0x10000 >= (STEPPER_TIMER_RATE), "SHAPING_FREQ_E is below the minimum (16) for AVR 16MHz.");
+      #endif
+    #endif
+  #endif
+#endif
+
+/**
+ * Fixed-Time Motion requirements
+ */
+#if ENABLED(FT_MOTION)
+  #ifndef CPU_32_BIT
+    #error "FT_MOTION requires a 32-bit processor."
+  #elif ENABLED(DIRECT_STEPPING)
+    #error "FT_MOTION is not compatible with DIRECT_STEPPING."
+  #elif ENABLED(MIXING_EXTRUDER)
+    #error "FT_MOTION is not compatible with MIXING_EXTRUDER."
+  #elif E_STEPPERS > 1
+    #error "FT_MOTION supports only one E stepper."
+  #elif HAS_CUTTER
+    #error "FT_MOTION is not compatible with a spindle or laser."
+  #endif
+  static_assert((FTM_FS) > 0 && (FTM_STEPPER_FS) % (FTM_FS) == 0, "FTM_STEPPER_FS must be a multiple of FTM_FS.");
+  static_assert((FTM_STEPPER_FS) <= (STEPPER_TIMER_RATE) / 10, "FTM_STEPPER_FS is too high for the stepper timer.");
+  static_assert(!((FTM_BUFFER_SIZE) & ((FTM_BUFFER_SIZE) - 1)), "FTM_BUFFER_SIZE must be a power of 2.");
+#endif
+
+/**
+ * Stepper ISR Profiler requirements
+ */
+#if ENABLED(STEPPER_ISR_PROFILE) && !(defined(__PLAT_LINUX__) || defined(__arm__) || defined(__thumb__))
+  #error "STEPPER_ISR_PROFILE requires an ARM processor or the LINUX HAL."
+#elif ENABLED(STEPPER_ISR_PROFILE) && defined(__ARM_ARCH_6M__)
+  #error "STEPPER_ISR_PROFILE requires the DWT cycle counter, which Cortex-M0/M0+ doesn't have."
+#endif
+
+/**
+ * Native arc blocks requirements
+ */
+#if ENABLED(ARC_NATIVE_BLOCKS)
+  #if DISABLED(ARC_SUPPORT)
+    #error "ARC_NATIVE_BLOCKS requires ARC_SUPPORT."
+  #elif DISABLED(FT_MOTION)
+    #error "ARC_NATIVE_BLOCKS requires FT_MOTION."
+  #elif IS_KINEMATIC || ANY(IS_CORE, MARKFORGED_XY, MARKFORGED_YX)
+    #error "ARC_NATIVE_BLOCKS requires a Cartesian machine."
+  #elif ENABLED(SKEW_CORRECTION)
+    #error "ARC_NATIVE_BLOCKS is not compatible with SKEW_CORRECTION."
+  #elif ENABLED(BACKLASH_COMPENSATION)
+    #error "ARC_NATIVE_BLOCKS is not compatible with BACKLASH_COMPENSATION."
+  #elif HAS_CLASSIC_JERK
+    #error "ARC_NATIVE_BLOCKS requires Junction Deviation. Disable CLASSIC_JERK."
   #endif
 #endif
 
@@ -568,6 +568,28 @@ void menu_backlash();
         else
           ACTION_ITEM_N(Y_AXIS, MSG_SHAPING_ENABLE, []{ stepper.set_shaping_frequency(Y_AXIS, SHAPING_FREQ_Y); });
       #endif
+      #if ENABLED(INPUT_SHAPING_Z)
+        editable.decimal = stepper.get_shaping_frequency(Z_AXIS);
+        if (editable.decimal) {
+          ACTION_ITEM_N(Z_AXIS, MSG_SHAPING_DISABLE, []{ stepper.set_shaping_frequency(Z_AXIS, 0.0f); });
+          EDIT_ITEM_FAST_N(float61, Z_AXIS, MSG_SHAPING_FREQ, &editable.decimal, min_frequency, 200.0f, []{ stepper.set_shaping_frequency(Z_AXIS, editable.decimal); });
+          editable.decimal = stepper.get_shaping_damping_ratio(Z_AXIS);
+          EDIT_ITEM_FAST_N(float42_52, Z_AXIS, MSG_SHAPING_ZETA, &editable.decimal, 0.0f, 1.0f, []{ stepper.set_shaping_damping_ratio(Z_AXIS, editable.decimal); });
+        }
+        else
+          ACTION_ITEM_N(Z_AXIS, MSG_SHAPING_ENABLE, []{ stepper.set_shaping_frequency(Z_AXIS, SHAPING_FREQ_Z); });
+      #endif
+      #if ENABLED(INPUT_SHAPING_E)
+        editable.decimal = stepper.get_shaping_frequency(E_AXIS);
+        if (editable.decimal) {
+          ACTION_ITEM_N(E_AXIS, MSG_SHAPING_DISABLE, []{ stepper.set_shaping_frequency(E_AXIS, 0.0f); });
+          EDIT_ITEM_FAST_N(float61, E_AXIS, MSG_SHAPING_FREQ, &editable.decimal, min_frequency, 200.0f, []{ stepper.set_shaping_frequency(E_AXIS, editable.decimal); });
+          editable.decimal = stepper.get_shaping_damping_ratio(E_AXIS);
+          EDIT_ITEM_FAST_N(float42_52, E_AXIS, MSG_SHAPING_ZETA, &editable.decimal, 0.0f, 1.0f, []{ stepper.set_shaping_damping_ratio(E_AXIS, editable.decimal); });
+        }
+        else
+          ACTION_ITEM_N(E_AXIS, MSG_SHAPING_ENABLE, []{ stepper.set_shaping_frequency(E_AXIS, SHAPING_FREQ_E); });
+      #endif
 
       END_MENU();
     }
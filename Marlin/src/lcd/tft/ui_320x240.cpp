@@ -476,6 +476,16 @@ void MenuItem_confirm::draw_select_screen(FSTR_P const yes, FSTR_P const no, con
     tft_string.add(ui8tostr2(bafsd.current_port()));
     tft_string.add(" / ");
     tft_string.add(ui8tostr2(bafsd.next_port()));
+    #if ENABLED(BAFSD_ODOMETER)
+      // Meters left on the spool being loaded, or fed so far when its length is unknown
+      const uint8_t p = bafsd.next_port() < EXTRUDERS ? bafsd.next_port() : bafsd.current_port();
+      if (p < EXTRUDERS) {
+        const float mm = bafsd.spool_mm[p] ? bafsd.remaining(p) : bafsd.used(p);
+        tft_string.add(' ');
+        tft_string.add(ui16tostr4rj(uint16_t(_MAX(mm, 0.0f) * 0.001f)));
+        tft_string.add('m');
+      }
+    #endif
     #endif
     tft_string.trim();
     tft.add_text(tft_string.center(TFT_WIDTH), MENU_TEXT_Y_OFFSET, COLOR_MENU_TEXT, tft_string);
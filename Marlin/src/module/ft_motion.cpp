@@ -0,0 +1,292 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2023 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * ft_motion.cpp
+ *
+ * Each block's trapezoid (or S-curve) is turned into a position over time.
+ * The position is sampled every FTM_TICKS_PER_SAMPLE ISR ticks and the steps
+ * made by each axis in that time are spread evenly over the ticks. A block
+ * is stretched to a whole number of ticks, which changes its duration by
+ * less than one tick.
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if ENABLED(FT_MOTION)
+
+#include "ft_motion.h"
+#include "stepper.h"
+
+#if HAS_FILAMENT_RUNOUT_DISTANCE
+  #include "../feature/runout.h"
+#endif
+
+#if ENABLED(POWER_LOSS_RECOVERY)
+  #include "../feature/powerloss.h"
+#endif
+
+FTMotion ftMotion;
+
+bool FTMotion::active = ENABLED(FTM_DEFAULT_ENABLED);
+
+ft_command_t FTMotion::commands[FTM_BUFFER_SIZE];
+volatile uint16_t FTMotion::cmd_head, FTMotion::cmd_tail;
+
+block_t *FTMotion::block;
+float FTMotion::v0, FTMotion::vp, FTMotion::vf,
+      FTMotion::t1, FTMotion::t2, FTMotion::t3,
+      FTMotion::s0, FTMotion::d1, FTMotion::d2,
+      FTMotion::tick_s;
+uint32_t FTMotion::ticks, FTMotion::tick;
+abce_long_t FTMotion::target, FTMotion::pending;
+volatile bool FTMotion::sampling, FTMotion::starved;
+uint16_t FTMotion::underruns;
+
+static_assert(FTM_TICKS_PER_SAMPLE >= 1 && (FTM_BUFFER_SIZE) >= 2 * FTM_TICKS_PER_SAMPLE, "FTM_BUFFER_SIZE must hold at least two samples.");
+static_assert(LOGICAL_AXES <= 16, "FT_MOTION supports up to 16 axes.");
+
+// Switch modes with both engines idle
+void FTMotion::set_active(const bool on) {
+  if (on == active) return;
+  planner.synchronize();
+  sync_shaping();
+  active = on;
+}
+
+/**
+ * The input shaper tracks where the trapezoid ISR left each shaped axis.
+ * Moves played back here don't go through it, so bring it up to date.
+ */
+void FTMotion::sync_shaping() {
+  #if HAS_SHAPING
+    const bool was_on = hal.isr_state();
+    hal.isr_off();
+    LOOP_L_N(a, NUM_SHAPED_AXES) stepper.shaping[a].last_block_end_pos = stepper.count_position[shaped_axis[a]];
+    if (was_on) hal.isr_on();
+  #endif
+}
+
+/**
+ * Leading axis steps done after t seconds of a ramp from va to vb lasting T.
+ * The velocity follows the same curve as the trapezoid ISR: linear, or the
+ * quintic Bézier with S_CURVE_ACCELERATION. Both take T = 2d / (va + vb).
+ */
+static inline float ramp(const float va, const float vb, const float T, const float t) {
+  const float u = t / T;
+  #if ENABLED(S_CURVE_ACCELERATION)
+    const float g = sq(sq(u)) * (2.5f - u * (3.0f - u));  // Integral of 10u^3 - 15u^4 + 6u^5
+  #else
+    const float g = 0.5f * sq(u);
+  #endif
+  return va * t + (vb - va) * T * g;
+}
+
+float FTMotion::position_at(const float t) {
+  if (t < t1) return s0 + ramp(v0, vp, t1, t);
+  if (t < t2) return d1 + vp * (t - t1);
+  if (t < t3) return d2 + ramp(vp, vf, t3 - t2, t - t2);
+  return block->step_event_count;
+}
+
+bool FTMotion::has_pending() {
+  LOOP_LOGICAL_AXES(i) if (pending[i]) return true;
+  return false;
+}
+
+// Work out the time profile of a new move block
+void FTMotion::start_block() {
+  const uint32_t n = block->step_event_count;
+  s0 = 0;
+  d1 = block->accelerate_until;
+  d2 = block->decelerate_after;
+
+  v0 = block->initial_rate;
+  vf = block->final_rate;
+  #if ENABLED(S_CURVE_ACCELERATION)
+    vp = block->cruise_rate;
+  #else
+    vp = d1 ? SQRT(sq(v0) + 2.0f * block->acceleration_steps_per_s2 * d1) : v0;
+    NOMORE(vp, float(block->nominal_rate));
+  #endif
+  NOLESS(vp, _MAX(v0, vf, 1.0f));
+
+  t1 = d1 ? 2.0f * d1 / (v0 + vp) : 0.0f;
+  t2 = t1 + (d2 - d1) / vp;
+  t3 = t2 + (n > d2 ? 2.0f * (n - d2) / (vp + vf) : 0.0f);
+
+  ticks = _MAX(1UL, uint32_t(CEIL(t3 * (FTM_STEPPER_FS))));
+  tick_s = t3 / ticks;
+  tick = 0;
+  target.reset();
+  pending.reset();
+
+  TERN_(POWER_LOSS_RECOVERY, recovery.info.sdpos = block->sdpos);
+  TERN_(POWER_LOSS_RECOVERY, recovery.info.current_position = block->start_position);
+}
+
+/**
+ * The ISR ran dry and the axes stopped mid-block. Rather than go on at
+ * the speed they stopped at, plan the rest of the block from a standstill:
+ * accelerate to the old peak rate, or as near as the steps left allow.
+ */
+void FTMotion::restart_block() {
+  const uint32_t n = block->step_event_count;
+  s0 = position_at(tick * tick_s);
+  const float a = _MAX(float(block->acceleration_steps_per_s2), 1.0f),
+              rest = n - s0;
+  v0 = 0;
+  vp = _MAX(_MIN(vp, SQRT(a * rest + 0.5f * sq(vf))), 1.0f);
+  NOMORE(vf, vp);
+  d1 = s0 + sq(vp) / (2.0f * a);
+  d2 = n - (sq(vp) - sq(vf)) / (2.0f * a);
+  NOMORE(d1, d2);
+
+  t1 = 2.0f * (d1 - s0) / vp;
+  t2 = t1 + (d2 - d1) / vp;
+  t3 = t2 + (n > d2 ? 2.0f * (n - d2) / (vp + vf) : 0.0f);
+
+  ticks = _MAX(1UL, uint32_t(CEIL(t3 * (FTM_STEPPER_FS))));
+  tick_s = t3 / ticks;
+  tick = 0;
+}
+
+// Signed steps of an axis from the start of the block to its end
+static inline int32_t block_steps(const block_t * const b, const uint8_t i) {
+  return TEST(b->direction_bits, i) ? -int32_t(b->steps[i]) : int32_t(b->steps[i]);
+}
+
+/**
+ * Fill n ticks. The trajectory moves to leading axis step s and each axis
+ * steps at most once per tick. Steps beyond that wait for the next ticks.
+ */
+void FTMotion::sample(const uint16_t n, const float s) {
+  const float f = s / block->step_event_count;
+  const bool last = tick >= ticks;
+  int16_t todo[LOGICAL_AXES];
+  uint16_t acc[LOGICAL_AXES];
+  axis_bits_t dirs = block->direction_bits;
+  LOOP_LOGICAL_AXES(i) {
+    const int32_t end = block_steps(block, i),
+                  to = last ? end : int32_t(LROUND(f * end));
+    pending[i] += to - target[i];
+    target[i] = to;
+    acc[i] = n / 2;
+  }
+
+  #if ENABLED(ARC_NATIVE_BLOCKS)
+    // The plane axes of an arc follow the circle. They may turn around within the block.
+    if (block->is_arc() && !last) {
+      const block_arc_t &arc = block->arc;
+      const float a = f * arc.angle, c = cos(a) - 1.0f, sn = sin(a);
+      const int32_t to_p = LROUND(arc.r_p.a * c - arc.r_p.b * sn),
+                    to_q = LROUND(arc.r_q.a * sn + arc.r_q.b * c);
+      pending[arc.axis_p] += to_p - target[arc.axis_p]; target[arc.axis_p] = to_p;
+      pending[arc.axis_q] += to_q - target[arc.axis_q]; target[arc.axis_q] = to_q;
+    }
+  #endif
+
+  LOOP_LOGICAL_AXES(i) {
+    todo[i] = constrain(pending[i], -int32_t(n), int32_t(n));
+    pending[i] -= todo[i];
+    if (todo[i]) SET_BIT_TO(dirs, i, todo[i] < 0);
+    todo[i] = ABS(todo[i]);
+  }
+
+  const ft_command_t dir_bits = ft_command_t(dirs) << FTM_DIR_SHIFT;
+  LOOP_L_N(j, n) {
+    ft_command_t c = dir_bits;
+    LOOP_LOGICAL_AXES(i) {
+      acc[i] += todo[i];
+      if (acc[i] >= n) { acc[i] -= n; SBI(c, i); }
+    }
+    push(c);
+  }
+}
+
+// The block is fully sampled. Hand it back to the planner.
+void FTMotion::end_block() {
+  sampling = starved = false;
+  TERN_(HAS_FILAMENT_RUNOUT_DISTANCE, runout.block_completed(block));
+  stepper.discard_current_block();
+  block = nullptr;
+}
+
+void FTMotion::loop() {
+  if (!active) return;
+
+  // Quick stop: drop the block and every step not yet played
+  if (stepper.abort_current_block) {
+    hal.isr_off();
+    flush();
+    if (block) stepper.discard_current_block();
+    stepper.abort_current_block = false;
+    sampling = starved = false;
+    hal.isr_on();
+    block = nullptr;
+    return;
+  }
+
+  for (;;) {
+    if (!block) {
+      if (!(block = planner.get_current_block())) return;
+      // The stepper owns the block while it's sampled, so the planner leaves it alone
+      stepper.current_block = block;
+      if (block->is_move()) start_block();
+    }
+
+    // Sync blocks take effect once the steps queued before them are played
+    if (block->is_sync()) {
+      if (has_command()) return;
+      TERN_(LASER_SYNCHRONOUS_M106_M107, if (block->is_fan_sync()) planner.sync_fan_speeds(block->fan_speed));
+      if (!block->is_fan_sync()) {
+        sync_shaping();
+        hal.isr_off();
+        stepper._set_position(block->position);
+        hal.isr_on();
+      }
+      stepper.discard_current_block();
+      block = nullptr;
+      continue;
+    }
+
+    if (free_commands() < FTM_TICKS_PER_SAMPLE) return;
+
+    if (starved) {
+      if (tick < ticks) restart_block();
+      starved = false;
+    }
+
+    if (tick < ticks) {
+      const uint16_t n = _MIN(uint32_t(FTM_TICKS_PER_SAMPLE), ticks - tick);
+      tick += n;
+      sample(n, tick < ticks ? position_at(tick * tick_s) : float(block->step_event_count));
+      sampling = tick < ticks;  // From the first steps in the buffer until the last are sampled
+    }
+    else if (has_pending())
+      sample(FTM_TICKS_PER_SAMPLE, block->step_event_count);  // Catch up on steps that ran over the max rate
+
+    if (tick >= ticks && !has_pending()) end_block();
+  }
+}
+
+#endif // FT_MOTION
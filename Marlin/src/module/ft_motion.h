@@ -0,0 +1,114 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2023 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * ft_motion.h
+ *
+ * Fixed-time motion. Planner blocks are sampled at FTM_FS in the main loop
+ * and turned into one step command per stepper ISR tick. The ISR only plays
+ * the commands back at FTM_STEPPER_FS, one step per axis at most per tick.
+ */
+
+#include "planner.h"
+
+// Ticks of the stepper ISR per trajectory sample
+#define FTM_TICKS_PER_SAMPLE ((FTM_STEPPER_FS) / (FTM_FS))
+
+// Stepper timer counts between two playback ticks
+#define FTM_ISR_INTERVAL ((STEPPER_TIMER_RATE) / (FTM_STEPPER_FS))
+
+// One ISR tick: a step bit per axis in the low half, the direction bits in the high half
+typedef IF<(LOGICAL_AXES > 8), uint32_t, uint16_t>::type ft_command_t;
+#define FTM_DIR_SHIFT (sizeof(ft_command_t) * 4)
+
+class FTMotion {
+  public:
+    static bool active;                             // Use fixed-time motion instead of the trapezoid ISR. M493 S
+
+    static void loop();                             // Called from idle(). Keeps the command buffer filled.
+    static void set_active(const bool on);
+
+    // Steps are buffered or a block is being sampled
+    static bool busy() { return has_command() || block; }
+
+    // Command buffer, filled by loop() and drained by the stepper ISR
+    static ft_command_t commands[FTM_BUFFER_SIZE];
+    static volatile uint16_t cmd_head, cmd_tail;
+
+    FORCE_INLINE static bool has_command() { return cmd_head != cmd_tail; }
+    FORCE_INLINE static ft_command_t next_command() {
+      const ft_command_t c = commands[cmd_tail];
+      cmd_tail = (cmd_tail + 1) & (FTM_BUFFER_SIZE - 1);
+      return c;
+    }
+    FORCE_INLINE static void flush() { cmd_tail = cmd_head; }
+
+    // The ISR ran out of steps in the middle of a move
+    static volatile bool sampling, starved;
+    static uint16_t underruns;                      // Times it happened. M493 R clears.
+    FORCE_INLINE static void underrun() {
+      if (sampling && !starved) { starved = true; underruns++; }
+    }
+
+  private:
+    static block_t *block;                          // The block being sampled
+
+    // The block's time profile, in seconds and leading axis steps
+    static float v0, vp, vf,                        // Entry, peak and exit rate
+                 t1, t2, t3,                        // End of acceleration, start and end of deceleration
+                 s0, d1, d2,                        // Steps at the start of the profile, the end of acceleration and the start of deceleration
+                 tick_s;                            // Block time per ISR tick
+    static uint32_t ticks, tick;                    // Ticks in the block, ticks sampled so far
+    static abce_long_t target,                      // Steps the trajectory has reached on each axis
+                       pending;                     // Steps not yet placed in a tick (above the max step rate)
+
+    static uint16_t free_commands() { return (cmd_tail - cmd_head - 1) & (FTM_BUFFER_SIZE - 1); }
+    static void push(const ft_command_t c) {
+      commands[cmd_head] = c;
+      cmd_head = (cmd_head + 1) & (FTM_BUFFER_SIZE - 1);
+    }
+
+    static void sync_shaping();
+    static void start_block();
+    static void restart_block();
+    static void end_block();
+    static bool has_pending();
+    static float position_at(const float t);
+    static void sample(const uint16_t n, const float s);
+};
+
+extern FTMotion ftMotion;
+
+// Use the trapezoid ISR while in scope, e.g. for homing and probing which need the endstops
+class FTMotionDisableInScope {
+  public:
+    FTMotionDisableInScope() {
+      was_active = FTMotion::active;
+      if (was_active) FTMotion::set_active(false);
+    }
+    ~FTMotionDisableInScope() {
+      if (was_active) FTMotion::set_active(true);
+    }
+  private:
+    bool was_active;
+};
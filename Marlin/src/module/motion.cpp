@@ -1139,12 +1139,13 @@ FORCE_INLINE void segment_idle(millis_t &next_idle_ms) {
     while (--segments) {
       segment_idle(next_idle_ms);
       raw += segment_distance;
-      if (!planner.buffer_line(raw, scaled_fr_mm_s, active_extruder, hints))
+      if (!planner.coalesce_line(raw, scaled_fr_mm_s, active_extruder, hints))
         break;
     }
 
     // Ensure last segment arrives at target location.
-    planner.buffer_line(destination, scaled_fr_mm_s, active_extruder, hints);
+    planner.coalesce_line(destination, scaled_fr_mm_s, active_extruder, hints);
+    planner.coalesce_flush();
 
     return false; // caller will update current_position
   }
@@ -1202,13 +1203,14 @@ FORCE_INLINE void segment_idle(millis_t &next_idle_ms) {
       while (--segments) {
         segment_idle(next_idle_ms);
         raw += segment_distance;
-        if (!planner.buffer_line(raw, fr_mm_s, active_extruder, hints))
+        if (!planner.coalesce_line(raw, fr_mm_s, active_extruder, hints))
           break;
       }
 
       // Since segment_distance is only approximate,
       // the final move must be to the exact destination.
-      planner.buffer_line(destination, fr_mm_s, active_extruder, hints);
+      planner.coalesce_line(destination, fr_mm_s, active_extruder, hints);
+      planner.coalesce_flush();
     }
 
   #endif // SEGMENT_LEVELED_MOVES && !AUTO_BED_LEVELING_UBL
@@ -1246,6 +1248,7 @@ FORCE_INLINE void segment_idle(millis_t &next_idle_ms) {
             #elif ENABLED(AUTO_BED_LEVELING_BILINEAR)
               bedlevel.line_to_destination(scaled_fr_mm_s);
             #endif
+            planner.coalesce_flush();
             return true;
           }
         #endif
@@ -110,6 +110,14 @@
   #include "../feature/spindle_laser.h"
 #endif
 
+#if ENABLED(FT_MOTION)
+  #include "ft_motion.h"
+#endif
+
+#if ENABLED(LINUX_BENCHMARK)
+  #include "../HAL/LINUX/benchmark.h"
+#endif
+
 // Delay for delivery of first block to the stepper ISR, if the queue contains 2 or
 // fewer movements. The delay is measured in milliseconds, and must be less than 250ms
 #define BLOCK_DELAY_FOR_1ST_MOVE 100
@@ -122,6 +130,7 @@ Planner planner;
  * A ring buffer of moves described in steps
  */
 block_t Planner::block_buffer[BLOCK_BUFFER_SIZE];
+block_plan_t Planner::plan_buffer[BLOCK_PLAN_SIZE]; // Planning records of the newest blocks
 volatile uint8_t Planner::block_buffer_head,    // Index of the next block to be pushed
                  Planner::block_buffer_nonbusy, // Index of the first non-busy block
                  Planner::block_buffer_planned, // Index of the optimally planned block
@@ -263,7 +272,7 @@ void Planner::init() {
   #endif
 }
 
-#if ENABLED(S_CURVE_ACCELERATION)
+#if ENABLED(S_CURVE_ACCELERATION) && !HAS_RAMP_TABLE
   #ifdef __AVR__
     /**
      * This routine returns 0x1000000 / d, getting the inverse as fast as possible.
@@ -769,9 +778,94 @@ block_t* Planner::get_current_block() {
   return nullptr;
 }
 
+#if ENABLED(PLANNER_FIXED_POINT)
+
+  // Integer square root, rounded down
+  template <typename T>
+  static T isqrt(T n) {
+    T r = 0, b = T(1) << (sizeof(T) * 8 - 2);
+    while (b > n) b >>= 2;
+    for (; b; b >>= 2) {
+      if (n >= r + b) { n -= r + b; r = (r >> 1) + b; }
+      else r >>= 1;
+    }
+    return r;
+  }
+
+  // The step rate for a speed^2, rounded up like the float math
+  static uint32_t rate_for_speed_sqr(speed_sqr_t v_sqr, const uint32_t rate_per_speed) {
+    // Shift up for more fraction bits in the root at low speeds
+    uint8_t fract = (SPEED_SQR_FRACT) / 2 + 16;
+    while (v_sqr && v_sqr < _BV32(30) && fract < 32) { v_sqr <<= 2; fract++; }
+    return uint32_t((uint64_t(isqrt(v_sqr)) * rate_per_speed + (uint64_t(1) << fract) - 1) >> fract);
+  }
+
+  // Steps to go from rate r0 up to r1 with twice the acceleration 'accel2'. 32-bit math when the rates allow.
+  static uint32_t rate_change_steps(const uint32_t r1, const uint32_t r0, const uint32_t accel2, const bool round_up) {
+    if (r1 + r0 <= 0xFFFFUL) {
+      const uint32_t d = (r1 + r0) * (r1 - r0);
+      return d / accel2 + (round_up && d % accel2);
+    }
+    const uint64_t d = uint64_t(r1 + r0) * (r1 - r0);
+    return uint32_t(d / accel2 + (round_up && d % accel2));
+  }
+
+#endif
+
+#if HAS_RAMP_TABLE
+
+  // The rate at 't' on the Bézier speed curve from v0 to v1 over 'time'
+  static uint32_t bezier_rate(const uint32_t v0, const uint32_t v1, uint32_t t, uint32_t time) {
+    // Position on the curve as 1.15 fixed point
+    while (time >= _BV32(16)) { t >>= 1; time >>= 1; }
+    const uint32_t u = (t << 15) / time,
+                   u2 = (u * u) >> 15, u3 = (u2 * u) >> 15,
+                   // 10u^3 - 15u^4 + 6u^5, the same curve the Stepper ISR would evaluate
+                   h = (u3 * ((6 * u2 + 10 * _BV32(15) - 15 * u) >> 4)) >> 11;
+    return v1 > v0 ? v0 + uint32_t((uint64_t(v1 - v0) * h) >> 15)
+                   : v0 - uint32_t((uint64_t(v0 - v1) * h) >> 15);
+  }
+
+  /**
+   * Break the speed ramp from v0 to v1 over 'time' into no more than S_CURVE_RAMP_PIECES
+   * pieces, each a power of 2 timer ticks long so the Stepper ISR can find them with a shift.
+   * The last piece is cut short by the end of the ramp, so its end rate is set further
+   * along the line to (time, v1). The Stepper ISR stops the rate at v1.
+   * The steps per ISR are for the rates the ISR runs at, with 'oversampling' applied.
+   */
+  static void fill_ramp_table(ramp_table_t &ramp, const uint32_t v0, const uint32_t v1, const uint32_t time, const uint8_t oversampling) {
+    uint8_t bits = 0;
+    if (time) while (bits < 23 && ((time - 1) >> bits) >= (S_CURVE_RAMP_PIECES)) bits++;
+    const uint8_t pieces = time ? _MIN(((time - 1) >> bits) + 1, uint32_t(S_CURVE_RAMP_PIECES)) : 0;
+    ramp.piece_bits = bits;
+    ramp.pieces = pieces;
+
+    ramp.rate[0] = v0;
+    for (uint8_t i = 1; i < pieces; ++i) ramp.rate[i] = bezier_rate(v0, v1, uint32_t(i) << bits, time);
+
+    if (pieces) {
+      const uint32_t t0 = uint32_t(pieces - 1) << bits, r0 = ramp.rate[pieces - 1],
+                     dr = v1 > r0 ? v1 - r0 : r0 - v1,
+                     dv = v1 > v0 ? v1 - v0 : v0 - v1,
+                     rest = time - t0;
+      // Stretch the change over the rest of the ramp to a whole piece, by a ratio with 8 fraction bits
+      uint32_t ext = dv;
+      if (rest > (_BV32(bits) >> 8)) NOMORE(ext, uint32_t((uint64_t(dr) * ((_BV32(bits) << 8) / rest)) >> 8));
+      ramp.rate[pieces] = v1 > r0 ? r0 + ext : r0 - _MIN(ext, r0);
+    }
+
+    // Enough steps per ISR for the fastest rate in each piece
+    for (uint8_t i = 0; i < pieces; ++i)
+      ramp.shift[i] = stepper.calc_multistep_shift(_MAX(ramp.rate[i], i + 1 < pieces ? ramp.rate[i + 1] : v1) << oversampling);
+    ramp.shift[pieces] = stepper.calc_multistep_shift(v1 << oversampling);
+  }
+
+#endif
+
 /**
  * Calculate trapezoid parameters, multiplying the entry- and exit-speeds
- * by the provided factors.
+ * by the provided factors. With PLANNER_FIXED_POINT the entry- and exit-speeds
+ * squared are given instead and there's no float math.
  **
  * ############ VERY IMPORTANT ############
  * NOTE that the PRECONDITION to call this function is that the block is
@@ -779,11 +873,21 @@ block_t* Planner::get_current_block() {
  * is not and will not use the block while we modify it, so it is safe to
  * alter its values.
  */
+#if ENABLED(PLANNER_FIXED_POINT)
+void Planner::calculate_trapezoid_for_block(block_t * const block, const speed_sqr_t entry_speed_sqr, const speed_sqr_t exit_speed_sqr) {
+
+  const uint32_t rate_per_speed = plan_of(block).rate_per_speed;
+  uint32_t initial_rate = _MIN(rate_for_speed_sqr(entry_speed_sqr, rate_per_speed), block->nominal_rate),
+           final_rate = _MIN(rate_for_speed_sqr(exit_speed_sqr, rate_per_speed), block->nominal_rate); // (steps per second)
+
+#else
 void Planner::calculate_trapezoid_for_block(block_t * const block, const_float_t entry_factor, const_float_t exit_factor) {
 
   uint32_t initial_rate = CEIL(block->nominal_rate * entry_factor),
            final_rate = CEIL(block->nominal_rate * exit_factor); // (steps per second)
 
+#endif
+
   // Limit minimal step rate (Otherwise the timer will overflow.)
   NOLESS(initial_rate, uint32_t(MINIMAL_STEP_RATE));
   NOLESS(final_rate, uint32_t(MINIMAL_STEP_RATE));
@@ -799,6 +903,36 @@ void Planner::calculate_trapezoid_for_block(block_t * const block, const_float_t
            decelerate_steps = 0;
 
   const int32_t accel = block->acceleration_steps_per_s2;
+
+  #if ENABLED(PLANNER_FIXED_POINT)
+
+    if (accel != 0) {
+      const uint32_t accel2 = 2 * accel;
+
+      // Steps required for acceleration, deceleration to/from nominal rate
+      if (initial_rate < block->nominal_rate) accelerate_steps = rate_change_steps(block->nominal_rate, initial_rate, accel2, true);
+      if (final_rate < block->nominal_rate) decelerate_steps = rate_change_steps(block->nominal_rate, final_rate, accel2, false);
+
+      // Steps between acceleration and deceleration, if any
+      plateau_steps -= accelerate_steps + decelerate_steps;
+
+      // No cruising. Meet where the ramps cross, half of the difference of the ramps from the middle.
+      if (plateau_steps < 0) {
+        const int32_t ramp_diff = final_rate >= initial_rate
+          ? int32_t(rate_change_steps(final_rate, initial_rate, accel2, false))
+          : -int32_t(rate_change_steps(initial_rate, final_rate, accel2, false));
+        accelerate_steps = constrain((int32_t(block->step_event_count) + ramp_diff + 1) / 2, int32_t(0), int32_t(block->step_event_count));
+        decelerate_steps = block->step_event_count - accelerate_steps;
+
+        #if EITHER(S_CURVE_ACCELERATION, LIN_ADVANCE)
+          // We won't reach the cruising rate. Let's calculate the rate we will reach
+          cruise_rate = isqrt(uint64_t(initial_rate) * initial_rate + uint64_t(accel2) * accelerate_steps);
+        #endif
+      }
+    }
+
+  #else
+
   float inverse_accel = 0.0f;
   if (accel != 0) {
     inverse_accel = 1.0f / accel;
@@ -829,21 +963,36 @@ void Planner::calculate_trapezoid_for_block(block_t * const block, const_float_t
     }
   }
 
+  #endif // !PLANNER_FIXED_POINT
+
   #if ENABLED(S_CURVE_ACCELERATION)
-    const float rate_factor = inverse_accel * (STEPPER_TIMER_RATE);
     // Jerk controlled speed requires to express speed versus time, NOT steps
-    uint32_t acceleration_time = rate_factor * float(cruise_rate - initial_rate),
-             deceleration_time = rate_factor * float(cruise_rate - final_rate),
-    // And to offload calculations from the ISR, we also calculate the inverse of those times here
-             acceleration_time_inverse = get_period_inverse(acceleration_time),
-             deceleration_time_inverse = get_period_inverse(deceleration_time);
+    #if ENABLED(PLANNER_FIXED_POINT)
+      const uint32_t acceleration_time = accel ? uint64_t(cruise_rate - initial_rate) * (STEPPER_TIMER_RATE) / accel : 0,
+                     deceleration_time = accel ? uint64_t(cruise_rate - final_rate) * (STEPPER_TIMER_RATE) / accel : 0;
+    #else
+      const float rate_factor = inverse_accel * (STEPPER_TIMER_RATE);
+      const uint32_t acceleration_time = rate_factor * float(cruise_rate - initial_rate),
+                     deceleration_time = rate_factor * float(cruise_rate - final_rate);
+    #endif
+    #if !HAS_RAMP_TABLE
+      // And to offload calculations from the ISR, we also calculate the inverse of those times here
+      const uint32_t acceleration_time_inverse = get_period_inverse(acceleration_time),
+                     deceleration_time_inverse = get_period_inverse(deceleration_time);
+    #endif
   #endif
 
   // Store new block parameters
   block->accelerate_until = accelerate_steps;
   block->decelerate_after = block->step_event_count - decelerate_steps;
   block->initial_rate = initial_rate;
-  #if ENABLED(S_CURVE_ACCELERATION)
+  #if HAS_RAMP_TABLE
+    // Or the whole curves, so the ISR only has to interpolate
+    const uint8_t oversampling = TERN0(ADAPTIVE_STEP_SMOOTHING, stepper.calc_oversampling(block->nominal_rate));
+    fill_ramp_table(block->accel_ramp, initial_rate, cruise_rate, acceleration_time, oversampling);
+    fill_ramp_table(block->decel_ramp, cruise_rate, final_rate, deceleration_time, oversampling);
+    block->cruise_rate = cruise_rate;
+  #elif ENABLED(S_CURVE_ACCELERATION)
     block->acceleration_time = acceleration_time;
     block->deceleration_time = deceleration_time;
     block->acceleration_time_inverse = acceleration_time_inverse;
@@ -986,15 +1135,17 @@ void Planner::reverse_pass_kernel(block_t * const current, const block_t * const
   OPTARG(HINTS_SAFE_EXIT_SPEED, const_float_t safe_exit_speed_sqr)
 ) {
   if (current) {
+    block_plan_t &plan = plan_of(current);
+
     // If entry speed is already at the maximum entry speed, and there was no change of speed
     // in the next block, there is no need to recheck. Block is cruising and there is no need to
     // compute anything for this block,
     // If not, block entry speed needs to be recalculated to ensure maximum possible planned speed.
-    const float max_entry_speed_sqr = current->max_entry_speed_sqr;
+    const speed_sqr_t max_entry_speed_sqr = plan.max_entry_speed_sqr;
 
     // Compute maximum entry speed decelerating over the current block from its exit speed.
     // If not at the maximum entry speed, or the previous block entry speed changed
-    if (current->entry_speed_sqr != max_entry_speed_sqr || (next && next->flag.recalculate)) {
+    if (plan.entry_speed_sqr != max_entry_speed_sqr || (next && next->flag.recalculate)) {
 
       // If nominal length true, max junction speed is guaranteed to be reached.
       // If a block can de/ac-celerate from nominal speed to zero within the length of the block, then
@@ -1004,11 +1155,11 @@ void Planner::reverse_pass_kernel(block_t * const current, const block_t * const
       // the reverse and forward planners, the corresponding block junction speed will always be at the
       // the maximum junction speed and may always be ignored for any speed reduction checks.
 
-      const float next_entry_speed_sqr = next ? next->entry_speed_sqr : _MAX(TERN0(HINTS_SAFE_EXIT_SPEED, safe_exit_speed_sqr), sq(float(MINIMUM_PLANNER_SPEED))),
-                  new_entry_speed_sqr = current->flag.nominal_length
-                    ? max_entry_speed_sqr
-                    : _MIN(max_entry_speed_sqr, max_allowable_speed_sqr(-current->acceleration, next_entry_speed_sqr, current->millimeters));
-      if (current->entry_speed_sqr != new_entry_speed_sqr) {
+      const speed_sqr_t next_entry_speed_sqr = next ? plan_of(next).entry_speed_sqr : to_speed_sqr(_MAX(TERN0(HINTS_SAFE_EXIT_SPEED, safe_exit_speed_sqr), sq(float(MINIMUM_PLANNER_SPEED)))),
+                        new_entry_speed_sqr = current->flag.nominal_length
+                          ? max_entry_speed_sqr
+                          : _MIN(max_entry_speed_sqr, max_allowable_speed_sqr(plan, next_entry_speed_sqr));
+      if (plan.entry_speed_sqr != new_entry_speed_sqr) {
 
         // Need to recalculate the block speed - Mark it now, so the stepper
         // ISR does not consume the block before being recalculated
@@ -1025,7 +1176,7 @@ void Planner::reverse_pass_kernel(block_t * const current, const block_t * const
         else {
           // Block is not BUSY so this is ahead of the Stepper ISR:
           // Just Set the new entry speed.
-          current->entry_speed_sqr = new_entry_speed_sqr;
+          plan.entry_speed_sqr = new_entry_speed_sqr;
         }
       }
     }
@@ -1084,17 +1235,20 @@ void Planner::reverse_pass(TERN_(HINTS_SAFE_EXIT_SPEED, const_float_t safe_exit_
 // The kernel called by recalculate() when scanning the plan from first to last entry.
 void Planner::forward_pass_kernel(const block_t * const previous, block_t * const current, const uint8_t block_index) {
   if (previous) {
+    const block_plan_t &prev_plan = plan_of(previous);
+    block_plan_t &plan = plan_buffer[PLAN_MOD(block_index)];
+
     // If the previous block is an acceleration block, too short to complete the full speed
     // change, adjust the entry speed accordingly. Entry speeds have already been reset,
     // maximized, and reverse-planned. If nominal length is set, max junction speed is
     // guaranteed to be reached. No need to recheck.
-    if (!previous->flag.nominal_length && previous->entry_speed_sqr < current->entry_speed_sqr) {
+    if (!previous->flag.nominal_length && prev_plan.entry_speed_sqr < plan.entry_speed_sqr) {
 
       // Compute the maximum allowable speed
-      const float new_entry_speed_sqr = max_allowable_speed_sqr(-previous->acceleration, previous->entry_speed_sqr, previous->millimeters);
+      const speed_sqr_t new_entry_speed_sqr = max_allowable_speed_sqr(prev_plan, prev_plan.entry_speed_sqr);
 
       // If true, current block is full-acceleration and we can move the planned pointer forward.
-      if (new_entry_speed_sqr < current->entry_speed_sqr) {
+      if (new_entry_speed_sqr < plan.entry_speed_sqr) {
 
         // Mark we need to recompute the trapezoidal shape, and do it now,
         // so the stepper ISR does not consume the block before being recalculated
@@ -1113,7 +1267,7 @@ void Planner::forward_pass_kernel(const block_t * const previous, block_t * cons
           // Block is not BUSY, we won the race against the Stepper ISR:
 
           // Always <= max_entry_speed_sqr. Backward pass sets this.
-          current->entry_speed_sqr = new_entry_speed_sqr; // Always <= max_entry_speed_sqr. Backward pass sets this.
+          plan.entry_speed_sqr = new_entry_speed_sqr; // Always <= max_entry_speed_sqr. Backward pass sets this.
 
           // Set optimal plan pointer.
           block_buffer_planned = block_index;
@@ -1125,7 +1279,7 @@ void Planner::forward_pass_kernel(const block_t * const previous, block_t * cons
     // point in the buffer. When the plan is bracketed by either the beginning of the
     // buffer and a maximum entry speed or two maximum entry speeds, every block in between
     // cannot logically be further improved. Hence, we don't have to recompute them anymore.
-    if (current->entry_speed_sqr == current->max_entry_speed_sqr)
+    if (plan.entry_speed_sqr == plan.max_entry_speed_sqr)
       block_buffer_planned = block_index;
   }
 }
@@ -1175,7 +1329,8 @@ void Planner::forward_pass() {
  */
 void Planner::recalculate_trapezoids(TERN_(HINTS_SAFE_EXIT_SPEED, const_float_t safe_exit_speed_sqr)) {
   // The tail may be changed by the ISR so get a local copy.
-  uint8_t block_index = block_buffer_tail,
+  // Older blocks are planned for good and have no planning record.
+  uint8_t block_index = plan_tail(),
           head_block_index = block_buffer_head;
   // Since there could be a sync block in the head of the queue, and the
   // next loop must not recalculate the head block (as it needs to be
@@ -1197,14 +1352,22 @@ void Planner::recalculate_trapezoids(TERN_(HINTS_SAFE_EXIT_SPEED, const_float_t
 
   // Go from the tail (currently executed block) to the first block, without including it)
   block_t *block = nullptr, *next = nullptr;
-  float current_entry_speed = 0.0f, next_entry_speed = 0.0f;
+  #if ENABLED(PLANNER_FIXED_POINT)
+    speed_sqr_t current_entry_speed_sqr = 0, next_entry_speed_sqr = 0;
+  #else
+    float current_entry_speed = 0.0f, next_entry_speed = 0.0f;
+  #endif
   while (block_index != head_block_index) {
 
     next = &block_buffer[block_index];
 
     // Only process movement blocks
     if (next->is_move()) {
-      next_entry_speed = SQRT(next->entry_speed_sqr);
+      #if ENABLED(PLANNER_FIXED_POINT)
+        next_entry_speed_sqr = plan_of(next).entry_speed_sqr;
+      #else
+        next_entry_speed = SQRT(plan_of(next).entry_speed_sqr);
+      #endif
 
       if (block) {
 
@@ -1220,9 +1383,13 @@ void Planner::recalculate_trapezoids(TERN_(HINTS_SAFE_EXIT_SPEED, const_float_t
           if (!stepper.is_block_busy(block)) {
             // Block is not BUSY, we won the race against the Stepper ISR:
 
-            // NOTE: Entry and exit factors always > 0 by all previous logic operations.
-            const float nomr = 1.0f / block->nominal_speed;
-            calculate_trapezoid_for_block(block, current_entry_speed * nomr, next_entry_speed * nomr);
+            #if ENABLED(PLANNER_FIXED_POINT)
+              calculate_trapezoid_for_block(block, current_entry_speed_sqr, next_entry_speed_sqr);
+            #else
+              // NOTE: Entry and exit factors always > 0 by all previous logic operations.
+              const float nomr = 1.0f / plan_of(block).nominal_speed;
+              calculate_trapezoid_for_block(block, current_entry_speed * nomr, next_entry_speed * nomr);
+            #endif
           }
 
           // Reset current only to ensure next trapezoid is computed - The
@@ -1232,7 +1399,7 @@ void Planner::recalculate_trapezoids(TERN_(HINTS_SAFE_EXIT_SPEED, const_float_t
       }
 
       block = next;
-      current_entry_speed = next_entry_speed;
+      TERN(PLANNER_FIXED_POINT, current_entry_speed_sqr = next_entry_speed_sqr, current_entry_speed = next_entry_speed);
     }
 
     block_index = next_block_index(block_index);
@@ -1241,7 +1408,11 @@ void Planner::recalculate_trapezoids(TERN_(HINTS_SAFE_EXIT_SPEED, const_float_t
   // Last/newest block in buffer. Always recalculated.
   if (block) {
     // Exit speed is set with MINIMUM_PLANNER_SPEED unless some code higher up knows better.
-    next_entry_speed = _MAX(TERN0(HINTS_SAFE_EXIT_SPEED, SQRT(safe_exit_speed_sqr)), float(MINIMUM_PLANNER_SPEED));
+    #if ENABLED(PLANNER_FIXED_POINT)
+      next_entry_speed_sqr = to_speed_sqr(_MAX(TERN0(HINTS_SAFE_EXIT_SPEED, safe_exit_speed_sqr), sq(float(MINIMUM_PLANNER_SPEED))));
+    #else
+      next_entry_speed = _MAX(TERN0(HINTS_SAFE_EXIT_SPEED, SQRT(safe_exit_speed_sqr)), float(MINIMUM_PLANNER_SPEED));
+    #endif
 
     // Mark the next(last) block as RECALCULATE, to prevent the Stepper ISR running it.
     // As the last block is always recalculated here, there is a chance the block isn't
@@ -1254,8 +1425,12 @@ void Planner::recalculate_trapezoids(TERN_(HINTS_SAFE_EXIT_SPEED, const_float_t
     if (!stepper.is_block_busy(block)) {
       // Block is not BUSY, we won the race against the Stepper ISR:
 
-      const float nomr = 1.0f / block->nominal_speed;
-      calculate_trapezoid_for_block(block, current_entry_speed * nomr, next_entry_speed * nomr);
+      #if ENABLED(PLANNER_FIXED_POINT)
+        calculate_trapezoid_for_block(block, current_entry_speed_sqr, next_entry_speed_sqr);
+      #else
+        const float nomr = 1.0f / plan_of(block).nominal_speed;
+        calculate_trapezoid_for_block(block, current_entry_speed * nomr, next_entry_speed * nomr);
+      #endif
     }
 
     // Reset block to ensure its trapezoid is computed - The stepper is free to use
@@ -1478,10 +1653,10 @@ void Planner::check_axes_activity() {
     if (thermalManager.degTargetHotend(active_extruder) < autotemp_min - 2) return; // Below the min?
 
     float high = 0.0f;
-    for (uint8_t b = block_buffer_tail; b != block_buffer_head; b = next_block_index(b)) {
+    for (uint8_t b = plan_tail(); b != block_buffer_head; b = next_block_index(b)) {
       const block_t * const block = &block_buffer[b];
       if (NUM_AXIS_GANG(block->steps.x, || block->steps.y, || block->steps.z, || block->steps.i, || block->steps.j, || block->steps.k, || block->steps.u, || block->steps.v, || block->steps.w)) {
-        const float se = float(block->steps.e) / block->step_event_count * block->nominal_speed; // mm/sec
+        const float se = float(block->steps.e) / block->step_event_count * plan_of(block).nominal_speed; // mm/sec
         NOLESS(high, se);
       }
     }
@@ -1495,6 +1670,32 @@ void Planner::check_axes_activity() {
 
 #endif
 
+#if ENABLED(MPC_FLOW_FEEDFORWARD)
+
+  /**
+   * The average filament feed rate into a hotend over the next few seconds
+   * of queued moves, for MPC to heat ahead of a change in flow. Retracts and
+   * moves of other hotends count as no flow. Only the part of the block being
+   * stepped that is still to go is counted.
+   */
+  float Planner::upcoming_e_speed(const uint8_t hotend, const_float_t seconds) {
+    float time = 0, e_mm = 0;
+    for (uint8_t b = block_buffer_tail; b != block_buffer_head && time < seconds; b = next_block_index(b)) {
+      block_t * const block = &block_buffer[b];
+      if (!block->is_move() || !block->nominal_rate) continue;
+      const float left = (b == block_buffer_tail && b != block_buffer_nonbusy) ? stepper.block_left() : 1.0f,
+                  block_time = left * block->step_event_count / block->nominal_rate,
+                  dt = _MIN(block_time, seconds - time);
+      if (block_time <= 0) continue;
+      if ((HOTENDS == 1 || block->extruder == hotend) && block->steps.e && !TEST(block->direction_bits, E_AXIS))
+        e_mm += left * block->steps.e * mm_per_step[E_AXIS_N(block->extruder)] * dt / block_time;
+      time += dt;
+    }
+    return time > 0 ? e_mm / time : 0;
+  }
+
+#endif
+
 #if DISABLED(NO_VOLUMETRICS)
 
   /**
@@ -1728,6 +1929,7 @@ bool Planner::busy() {
   return (has_blocks_queued() || cleaning_buffer_counter
       || TERN0(EXTERNAL_CLOSED_LOOP_CONTROLLER, CLOSED_LOOP_WAITING())
       || TERN0(HAS_SHAPING, stepper.input_shaping_busy())
+      || TERN0(FT_MOTION, ftMotion.busy())
   );
 }
 
@@ -1853,6 +2055,78 @@ bool Planner::_buffer_steps(const xyze_long_t &target
   return true;
 }
 
+#if ENABLED(JD_CORNER_BLENDING)
+
+  // The ends of the last few moves, relative to the end of the newest one
+  static float blend_points[JD_BLENDING_SEGMENTS + 1][XYZ];
+  static uint8_t blend_count;
+
+  FORCE_INLINE static float dot3(const float a[XYZ], const float b[XYZ]) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+  FORCE_INLINE static void cross3(float r[XYZ], const float a[XYZ], const float b[XYZ]) {
+    r[0] = a[1] * b[2] - a[2] * b[1];
+    r[1] = a[2] * b[0] - a[0] * b[2];
+    r[2] = a[0] * b[1] - a[1] * b[0];
+  }
+
+  /**
+   * Add a move to the window and find the circle through the oldest move end,
+   * the junction and the newest move end. If every move end and midpoint in the
+   * window is within JD_BLENDING_TOLERANCE of the circle the moves are taken for
+   * a sampled curve. Cornering at the speed for its radius then changes velocity
+   * at each junction by no more than SQRT(8 * accel * tolerance).
+   *
+   * A move with no XYZ length or a reset starts a new window.
+   *
+   * @return The radius of the curve, or 0 if the moves don't fit one
+   */
+  static float blend_radius(const float dist[XYZ], const bool reset) {
+    if (reset || !(dist[0] || dist[1] || dist[2])) blend_count = 0;
+    if (!blend_count) { ZERO(blend_points[0]); blend_count = 1; }
+    else if (blend_count > JD_BLENDING_SEGMENTS) {
+      memmove(blend_points[0], blend_points[1], sizeof(blend_points[0]) * (JD_BLENDING_SEGMENTS));
+      blend_count--;
+    }
+    LOOP_L_N(i, blend_count) LOOP_L_N(a, XYZ) blend_points[i][a] -= dist[a];
+    ZERO(blend_points[blend_count]);
+    blend_count++;
+    if (blend_count < 4) return 0;
+
+    // Circumcenter relative to the junction B, with the newest end at the origin
+    const float * const A = blend_points[0], * const B = blend_points[blend_count - 2];
+    float a[XYZ], b[XYZ], n[XYZ], bn[XYZ], na[XYZ], c[XYZ];
+    LOOP_L_N(i, XYZ) { a[i] = A[i] - B[i]; b[i] = -B[i]; }
+    cross3(n, a, b);
+    const float aa = dot3(a, a), bb = dot3(b, b), nn = dot3(n, n);
+    if (nn <= 1e-8f * aa * bb) return 0;  // Straight enough for plain JD
+    cross3(bn, b, n);
+    cross3(na, n, a);
+    const float inv = 0.5f / nn;
+    LOOP_L_N(i, XYZ) c[i] = (aa * bn[i] + bb * na[i]) * inv;
+    const float radius = SQRT(dot3(c, c));
+    LOOP_L_N(i, XYZ) c[i] += B[i];
+
+    // Distance from the circle: out of its plane, then off its rim
+    const float tol_sq = sq(float(JD_BLENDING_TOLERANCE)), inv_nn = 1.0f / nn;
+    auto off_curve = [&](const float p[XYZ]) {
+      float v[XYZ];
+      LOOP_L_N(i, XYZ) v[i] = p[i] - c[i];
+      const float h_sq = sq(dot3(v, n)) * inv_nn,
+                  r = SQRT(_MAX(dot3(v, v) - h_sq, 0.0f));
+      return h_sq + sq(r - radius) > tol_sq;
+    };
+    LOOP_L_N(j, blend_count) {
+      if (off_curve(blend_points[j])) return 0;
+      if (j) {
+        float m[XYZ];
+        LOOP_L_N(i, XYZ) m[i] = 0.5f * (blend_points[j - 1][i] + blend_points[j][i]);
+        if (off_curve(m)) return 0;
+      }
+    }
+    return radius;
+  }
+
+#endif // JD_CORNER_BLENDING
+
 /**
  * @brief Populate a block in preparation for insertion
  * @details Populate the fields of a new linear movement block
@@ -1876,6 +2150,8 @@ bool Planner::_populate_block(
   OPTARG(HAS_DIST_MM_ARG, const xyze_float_t &cart_dist_mm)
   , feedRate_t fr_mm_s, const uint8_t extruder, const PlannerHints &hints
 ) {
+  block_plan_t &plan = plan_of(block);
+
   int32_t LOGICAL_AXIS_LIST(
     de = target.e - position.e,
     da = target.a - position.a,
@@ -2017,6 +2293,18 @@ bool Planner::_populate_block(
   // Set direction bits
   block->direction_bits = dm;
 
+  #if ENABLED(ARC_NATIVE_BLOCKS)
+    if (hints.arc) {
+      const PlannerHints::arc_hint_t &arc = *hints.arc;
+      block->flag.arc = true;
+      block->arc.axis_p = arc.axis_p;
+      block->arc.axis_q = arc.axis_q;
+      block->arc.r_p = arc.rvec * settings.axis_steps_per_mm[arc.axis_p];
+      block->arc.r_q = arc.rvec * settings.axis_steps_per_mm[arc.axis_q];
+      block->arc.angle = arc.angle;
+    }
+  #endif
+
   /**
    * Update block laser power
    * For standard mode get the cutter.power value for processing, since it's
@@ -2135,7 +2423,7 @@ bool Planner::_populate_block(
     bool cartesian_move = true;
   #endif
 
-  if (true NUM_AXIS_GANG(
+  if (TERN1(ARC_NATIVE_BLOCKS, !hints.arc) NUM_AXIS_GANG(
       && block->steps.a < MIN_STEPS_PER_SEGMENT,
       && block->steps.b < MIN_STEPS_PER_SEGMENT,
       && block->steps.c < MIN_STEPS_PER_SEGMENT,
@@ -2147,11 +2435,11 @@ bool Planner::_populate_block(
       && block->steps.w < MIN_STEPS_PER_SEGMENT
     )
   ) {
-    block->millimeters = TERN0(HAS_EXTRUDERS, ABS(steps_dist_mm.e));
+    plan.millimeters = TERN0(HAS_EXTRUDERS, ABS(steps_dist_mm.e));
   }
   else {
     if (hints.millimeters)
-      block->millimeters = hints.millimeters;
+      plan.millimeters = hints.millimeters;
     else {
       /**
        * Distance for interpretation of feedrate in accordance with LinuxCNC (the successor of NIST
@@ -2217,7 +2505,7 @@ bool Planner::_populate_block(
         }
       #endif
 
-      block->millimeters = SQRT(distance_sqr);
+      plan.millimeters = SQRT(distance_sqr);
     }
 
     /**
@@ -2240,6 +2528,14 @@ bool Planner::_populate_block(
     block->steps.u, block->steps.v, block->steps.w
   ));
 
+  #if ENABLED(ARC_NATIVE_BLOCKS)
+    // An axis in the plane of an arc may travel up to the whole arc length, e.g., a full circle has no net steps
+    if (hints.arc) {
+      const float arc_mm = ABS(hints.arc->angle) * hints.arc->rvec.magnitude();
+      NOLESS(block->step_event_count, uint32_t(CEIL(arc_mm * _MAX(settings.axis_steps_per_mm[hints.arc->axis_p], settings.axis_steps_per_mm[hints.arc->axis_q]))));
+    }
+  #endif
+
   // Bail if this is a zero-length block
   if (block->step_event_count < MIN_STEPS_PER_SEGMENT) return false;
 
@@ -2350,7 +2646,7 @@ bool Planner::_populate_block(
   else
     NOLESS(fr_mm_s, settings.min_travel_feedrate_mm_s);
 
-  const float inverse_millimeters = 1.0f / block->millimeters;  // Inverse millimeters to remove multiple divides
+  const float inverse_millimeters = 1.0f / plan.millimeters;  // Inverse millimeters to remove multiple divides
 
   // Calculate inverse time for this move. No divide by zero due to previous checks.
   // Example: At 120mm/s a 60mm move involving XYZ axes takes 0.5s. So this will give 2.0.
@@ -2398,7 +2694,7 @@ bool Planner::_populate_block(
     if (was_enabled) stepper.wake_up();
   #endif
 
-  block->nominal_speed = block->millimeters * inverse_secs;           // (mm/sec) Always > 0
+  plan.nominal_speed = plan.millimeters * inverse_secs;           // (mm/sec) Always > 0
   block->nominal_rate = CEIL(block->step_event_count * inverse_secs); // (step/sec) Always > 0
 
   #if ENABLED(FILAMENT_WIDTH_SENSOR)
@@ -2494,7 +2790,7 @@ bool Planner::_populate_block(
   if (speed_factor < 1.0f) {
     current_speed *= speed_factor;
     block->nominal_rate *= speed_factor;
-    block->nominal_speed *= speed_factor;
+    plan.nominal_speed *= speed_factor;
   }
 
   // Compute and limit the acceleration rate for the trapezoid generator.
@@ -2503,7 +2799,7 @@ bool Planner::_populate_block(
   #if ENABLED(LIN_ADVANCE)
     bool use_advance_lead = false;
   #endif
-  if (NUM_AXIS_GANG(
+  if (TERN1(ARC_NATIVE_BLOCKS, !hints.arc) && NUM_AXIS_GANG(
          !block->steps.a, && !block->steps.b, && !block->steps.c,
       && !block->steps.i, && !block->steps.j, && !block->steps.k,
       && !block->steps.u, && !block->steps.v, && !block->steps.w)
@@ -2545,7 +2841,7 @@ bool Planner::_populate_block(
 
       if (use_advance_lead) {
         float e_D_ratio = (target_float.e - position_float.e) /
-          TERN(IS_KINEMATIC, block->millimeters,
+          TERN(IS_KINEMATIC, plan.millimeters,
             SQRT(sq(target_float.x - position_float.x)
                + sq(target_float.y - position_float.y)
                + sq(target_float.z - position_float.z))
@@ -2582,9 +2878,14 @@ bool Planner::_populate_block(
         LIMIT_ACCEL_FLOAT(U_AXIS, 0), LIMIT_ACCEL_FLOAT(V_AXIS, 0), LIMIT_ACCEL_FLOAT(W_AXIS, 0)
       );
     }
+    #if ENABLED(ARC_NATIVE_BLOCKS)
+      // Either axis of the arc plane may take the whole acceleration along the curve
+      if (hints.arc)
+        NOMORE(accel, uint32_t(_MIN(settings.max_acceleration_mm_per_s2[hints.arc->axis_p], settings.max_acceleration_mm_per_s2[hints.arc->axis_q]) * steps_per_mm));
+    #endif
   }
   block->acceleration_steps_per_s2 = accel;
-  block->acceleration = accel / steps_per_mm;
+  plan.acceleration = accel / steps_per_mm;
   #if DISABLED(S_CURVE_ACCELERATION)
     block->acceleration_rate = (uint32_t)(accel * (float(1UL << 24) / (STEPPER_TIMER_RATE)));
   #endif
@@ -2665,7 +2966,32 @@ bool Planner::_populate_block(
      * => normalize the complete junction vector.
      * Elsewise, when needed JD will factor-in the E component
      */
-    if (ANY(IS_CORE, MARKFORGED_XY, MARKFORGED_YX) || esteps > 0)
+    #if ENABLED(JD_CORNER_BLENDING)
+      // Arcs and curve hints already have a cornering radius
+      const float blend_dist[XYZ] = { unit_vec.x, unit_vec.y, unit_vec.z },
+                  blend_r = blend_radius(blend_dist, !moves_queued || UNEAR_ZERO(previous_nominal_speed)
+                                                     || TERN0(ARC_NATIVE_BLOCKS, hints.arc)
+                                                     || TERN0(HINTS_CURVE_RADIUS, hints.curve_radius));
+    #endif
+
+    #if ENABLED(ARC_NATIVE_BLOCKS)
+      // An arc meets its neighbors along its tangents, not its chord
+      xyze_float_t arc_exit_vec;
+      if (hints.arc) {
+        const PlannerHints::arc_hint_t &arc = *hints.arc;
+        // The tangent is the radius vector turned by 90°. Scaled by the angle it has the length of the flat arc.
+        const float c = cos(arc.angle), s = sin(arc.angle);
+        const ab_float_t rend = { arc.rvec.a * c - arc.rvec.b * s, arc.rvec.a * s + arc.rvec.b * c };
+        unit_vec[arc.axis_p] = -arc.rvec.b * arc.angle;
+        unit_vec[arc.axis_q] =  arc.rvec.a * arc.angle;
+        arc_exit_vec = unit_vec;
+        arc_exit_vec[arc.axis_p] = -rend.b * arc.angle;
+        arc_exit_vec[arc.axis_q] =  rend.a * arc.angle;
+        normalize_junction_vector(arc_exit_vec);
+      }
+    #endif
+
+    if (ANY(IS_CORE, MARKFORGED_XY, MARKFORGED_YX) || esteps > 0 || TERN0(ARC_NATIVE_BLOCKS, hints.arc))
       normalize_junction_vector(unit_vec);  // Normalize with XYZE components
     else
       unit_vec *= inverse_millimeters;      // Use pre-calculated (1 / SQRT(x^2 + y^2 + z^2))
@@ -2697,7 +3023,7 @@ bool Planner::_populate_block(
         xyze_float_t junction_unit_vec = unit_vec - prev_unit_vec;
         normalize_junction_vector(junction_unit_vec);
 
-        const float junction_acceleration = limit_value_by_axis_maximum(block->acceleration, junction_unit_vec);
+        const float junction_acceleration = limit_value_by_axis_maximum(plan.acceleration, junction_unit_vec);
 
         if (TERN0(HINTS_CURVE_RADIUS, hints.curve_radius)) {
           TERN_(HINTS_CURVE_RADIUS, vmax_junction_sqr = junction_acceleration * hints.curve_radius);
@@ -2712,7 +3038,7 @@ bool Planner::_populate_block(
           #if ENABLED(JD_HANDLE_SMALL_SEGMENTS)
 
             // For small moves with >135° junction (octagon) find speed for approximate arc
-            if (block->millimeters < 1 && junction_cos_theta < -0.7071067812f) {
+            if (plan.millimeters < 1 && junction_cos_theta < -0.7071067812f) {
 
               #if ENABLED(JD_USE_MATH_ACOS)
 
@@ -2791,20 +3117,24 @@ bool Planner::_populate_block(
 
               #endif
 
-              const float limit_sqr = (block->millimeters * junction_acceleration) / junction_theta;
+              const float limit_sqr = (plan.millimeters * junction_acceleration) / junction_theta;
               NOMORE(vmax_junction_sqr, limit_sqr);
             }
 
           #endif // JD_HANDLE_SMALL_SEGMENTS
+
+          // Take a sampled curve at the speed for its radius
+          TERN_(JD_CORNER_BLENDING, NOLESS(vmax_junction_sqr, junction_acceleration * blend_r));
         }
       }
 
       // Get the lowest speed
-      vmax_junction_sqr = _MIN(vmax_junction_sqr, sq(block->nominal_speed), sq(previous_nominal_speed));
+      vmax_junction_sqr = _MIN(vmax_junction_sqr, sq(plan.nominal_speed), sq(previous_nominal_speed));
     }
     else // Init entry speed to zero. Assume it starts from rest. Planner will correct this later.
       vmax_junction_sqr = 0;
 
+    TERN_(ARC_NATIVE_BLOCKS, if (hints.arc) unit_vec = arc_exit_vec);
     prev_unit_vec = unit_vec;
 
   #endif
@@ -2819,7 +3149,7 @@ bool Planner::_populate_block(
     static float previous_safe_speed;
 
     // Start with a safe speed (from which the machine may halt to stop immediately).
-    float safe_speed = block->nominal_speed;
+    float safe_speed = plan.nominal_speed;
 
     #ifndef TRAVEL_EXTRA_XYJERK
       #define TRAVEL_EXTRA_XYJERK 0
@@ -2832,7 +3162,7 @@ bool Planner::_populate_block(
                   maxj = (max_jerk[i] + (i == X_AXIS || i == Y_AXIS ? extra_xyjerk : 0.0f)); // mj : The max jerk setting for this axis
       if (jerk > maxj) {                          // cs > mj : New current speed too fast?
         if (limited) {                            // limited already?
-          const float mjerk = block->nominal_speed * maxj; // ns*mj
+          const float mjerk = plan.nominal_speed * maxj; // ns*mj
           if (jerk * safe_speed > mjerk) safe_speed = mjerk / jerk; // ns*mj/cs
         }
         else {
@@ -2855,8 +3185,8 @@ bool Planner::_populate_block(
       // The junction velocity will be shared between successive segments. Limit the junction velocity to their minimum.
       // Pick the smaller of the nominal speeds. Higher speed shall not be achieved at the junction during coasting.
       float smaller_speed_factor = 1.0f;
-      if (block->nominal_speed < previous_nominal_speed) {
-        vmax_junction = block->nominal_speed;
+      if (plan.nominal_speed < previous_nominal_speed) {
+        vmax_junction = plan.nominal_speed;
         smaller_speed_factor = vmax_junction / previous_nominal_speed;
       }
       else
@@ -2907,13 +3237,19 @@ bool Planner::_populate_block(
   #endif // Classic Jerk Limiting
 
   // Max entry speed of this block equals the max exit speed of the previous block.
-  block->max_entry_speed_sqr = vmax_junction_sqr;
+  plan.max_entry_speed_sqr = to_speed_sqr(vmax_junction_sqr);
 
   // Initialize block entry speed. Compute based on deceleration to user-defined MINIMUM_PLANNER_SPEED.
-  const float v_allowable_sqr = max_allowable_speed_sqr(-block->acceleration, sq(float(MINIMUM_PLANNER_SPEED)), block->millimeters);
+  const float v_allowable_sqr = max_allowable_speed_sqr(-plan.acceleration, sq(float(MINIMUM_PLANNER_SPEED)), plan.millimeters);
 
   // Start with the minimum allowed speed
-  block->entry_speed_sqr = sq(float(MINIMUM_PLANNER_SPEED));
+  plan.entry_speed_sqr = to_speed_sqr(sq(float(MINIMUM_PLANNER_SPEED)));
+
+  #if ENABLED(PLANNER_FIXED_POINT)
+    // The float math the lookahead and trapezoids need, done once for the block
+    plan.accel_speed_sqr = to_speed_sqr(2 * plan.acceleration * plan.millimeters);
+    plan.rate_per_speed = LROUND(block->nominal_rate * float(_BV32(16)) / plan.nominal_speed);
+  #endif
 
   // Initialize planner efficiency flags
   // Set flag if block will always reach maximum junction speed regardless of entry/exit speeds.
@@ -2923,11 +3259,13 @@ bool Planner::_populate_block(
   // block nominal speed limits both the current and next maximum junction speeds. Hence, in both
   // the reverse and forward planners, the corresponding block junction speed will always be at the
   // the maximum junction speed and may always be ignored for any speed reduction checks.
-  block->flag.set_nominal(sq(block->nominal_speed) <= v_allowable_sqr);
+  block->flag.set_nominal(sq(plan.nominal_speed) <= v_allowable_sqr);
 
   // Update previous path unit_vector and nominal speed
   previous_speed = current_speed;
-  previous_nominal_speed = block->nominal_speed;
+  previous_nominal_speed = plan.nominal_speed;
+
+  TERN_(LINUX_BENCHMARK, bench.block_planned(position, target));
 
   position = target;  // Update the position
 
@@ -3182,6 +3520,109 @@ bool Planner::buffer_line(const xyze_pos_t &cart, const_feedRate_t fr_mm_s
   #endif
 } // buffer_line()
 
+#if ENABLED(COALESCE_SEGMENTS)
+
+  // The segments held back by coalesce_line and coalesce_segment
+  static struct {
+    uint8_t count;                            // The number of segments held
+    bool segment,                             // Held for buffer_segment instead of buffer_line
+         start_valid;                         // 'start' is exact for 'start_steps'
+    xyze_pos_t start,                         // Start of the first segment, where the planner steps
+               ends[COALESCE_MAX_SEGMENTS],   // End of each segment, where the planner steps
+               target;                        // The last target, for buffer_line or buffer_segment
+    xyze_long_t start_steps;                  // Planner position when the start was set
+    feedRate_t fr_mm_s;
+    uint8_t extruder;
+    PlannerHints hints;                       // The last hints, with the summed length
+  } held;
+
+  // Are the held segment ends all within COALESCE_TOLERANCE of a line to 'p'?
+  static bool coalesce_fits(const xyze_pos_t &p) {
+    const xyze_float_t d = p - held.start;
+    float len_sq = 0;
+    LOOP_LOGICAL_AXES(i) len_sq += sq(d[i]);
+    if (len_sq < sq(COALESCE_TOLERANCE)) return false;
+
+    LOOP_L_N(n, held.count) {
+      const xyze_float_t v = held.ends[n] - held.start;
+      float dot = 0;
+      LOOP_LOGICAL_AXES(i) dot += v[i] * d[i];
+      const float t = dot / len_sq;
+      if (!WITHIN(t, 0.0f, 1.0f)) return false;
+      float dist_sq = 0;
+      LOOP_LOGICAL_AXES(i) dist_sq += sq(v[i] - t * d[i]);
+      if (dist_sq > sq(COALESCE_TOLERANCE)) return false;
+    }
+    return true;
+  }
+
+  bool Planner::coalesce(const xyze_pos_t &p, const xyze_pos_t &target, const bool segment
+    , const_feedRate_t fr_mm_s, const uint8_t extruder, const PlannerHints &hints
+  ) {
+    bool ok = true;
+    if (held.count && (held.count >= COALESCE_MAX_SEGMENTS || segment != held.segment
+      || fr_mm_s != held.fr_mm_s || extruder != held.extruder || !coalesce_fits(p))
+    ) ok = coalesce_flush();
+
+    if (held.count)
+      held.hints.millimeters = held.hints.millimeters && hints.millimeters ? held.hints.millimeters + hints.millimeters : 0;
+    else {
+      // Start from the planner position, exactly if it's where the last flush left it
+      if (!held.start_valid || position != held.start_steps) {
+        LOOP_NUM_AXES(i) held.start[i] = position[i] * mm_per_step[i];
+        TERN_(HAS_EXTRUDERS, held.start.e = position.e * mm_per_step[E_AXIS_N(extruder)]);
+      }
+      held.segment = segment;
+      held.fr_mm_s = fr_mm_s;
+      held.extruder = extruder;
+      held.hints = hints;
+    }
+
+    held.ends[held.count++] = p;
+    held.target = target;
+    return ok;
+  }
+
+  bool Planner::coalesce_line(const xyze_pos_t &cart, const_feedRate_t fr_mm_s
+    , const uint8_t extruder/*=active_extruder*/
+    , const PlannerHints &hints/*=PlannerHints()*/
+  ) {
+    // Where buffer_line will step to
+    xyze_pos_t p = cart;
+    TERN_(HAS_POSITION_MODIFIERS, apply_modifiers(p));
+    #if IS_KINEMATIC
+      inverse_kinematics(p);
+      TERN_(HAS_EXTRUDERS, delta.e = p.e);
+      p = delta;
+    #endif
+    return coalesce(p, cart, false, fr_mm_s, extruder, hints);
+  }
+
+  #if !IS_KINEMATIC
+    bool Planner::coalesce_segment(const abce_pos_t &abce, const_feedRate_t fr_mm_s, const uint8_t extruder/*=active_extruder*/) {
+      return coalesce(abce, abce, true, fr_mm_s, extruder, PlannerHints());
+    }
+  #endif
+
+  // Buffer the held segments as one line
+  bool Planner::coalesce_flush() {
+    if (!held.count) return true;
+    #if IS_KINEMATIC
+      const bool ok = buffer_line(held.target, held.fr_mm_s, held.extruder, held.hints);
+    #else
+      const bool ok = held.segment
+        ? buffer_segment(held.target, held.fr_mm_s, held.extruder)
+        : buffer_line(held.target, held.fr_mm_s, held.extruder, held.hints);
+    #endif
+    held.start = held.ends[held.count - 1];
+    held.start_steps = position;
+    held.start_valid = ok;
+    held.count = 0;
+    return ok;
+  }
+
+#endif // COALESCE_SEGMENTS
+
 #if ENABLED(DIRECT_STEPPING)
 
   void Planner::buffer_page(const page_idx_t page_idx, const uint8_t extruder, const uint16_t num_steps) {
@@ -3460,3 +3901,68 @@ void Planner::set_max_feedrate(const AxisEnum axis, float inMaxFeedrateMMS) {
   }
 
 #endif
+
+#if BOTH(PLANNER_FIXED_POINT, MARLIN_TEST_BUILD)
+
+  /**
+   * Check the fixed-point trapezoids against the float math over a range of
+   * machines, moves and junction speeds. Rates must be within 1 step/s + 0.1%
+   * and the ramps within 1 step + 0.1% of the block.
+   */
+  void Planner::test_fixed_point() {
+    // The next free block is a scratch block while the queue is empty
+    block_t * const block = &block_buffer[block_buffer_head];
+    block_plan_t &plan = plan_of(block);
+    block->reset();
+
+    static constexpr float steps_per_mm[] = { 80, 400, 3200 },
+                           speeds[] = { 5, 50, 200, 500 },
+                           accels[] = { 200, 3000, 20000 },
+                           lengths[] = { 0.1f, 1, 10, 200 },
+                           factors[] = { 0, 0.1f, 0.5f, 0.9f, 1 };
+
+    uint32_t cases = 0, fails = 0;
+    float max_rate_err = 0, max_steps_err = 0;
+
+    for (const float k : steps_per_mm) for (const float v : speeds) for (const float a : accels) for (const float mm : lengths) {
+      block->step_event_count = LROUND(mm * k);
+      block->nominal_rate = CEIL(v * k);
+      block->acceleration_steps_per_s2 = LROUND(a * k);
+      plan.nominal_speed = v;
+      plan.millimeters = mm;
+      plan.acceleration = a;
+      plan.accel_speed_sqr = to_speed_sqr(2 * a * mm);
+      plan.rate_per_speed = LROUND(block->nominal_rate * float(_BV32(16)) / v);
+
+      for (const float fe : factors) for (const float fx : factors) {
+        const float ve = _MAX(fe * v, float(MINIMUM_PLANNER_SPEED)), vx = _MAX(fx * v, float(MINIMUM_PLANNER_SPEED));
+        if (ABS(sq(vx) - sq(ve)) > 2 * a * mm) continue; // The lookahead never asks for these
+
+        // The float math, as calculate_trapezoid_for_block does it without PLANNER_FIXED_POINT
+        const float accel = block->acceleration_steps_per_s2, count = block->step_event_count,
+                    nominal_rate_sq = sq(float(block->nominal_rate)),
+                    initial_rate = _MAX(CEIL(block->nominal_rate * ve / v), float(MINIMAL_STEP_RATE)),
+                    final_rate = _MAX(CEIL(block->nominal_rate * vx / v), float(MINIMAL_STEP_RATE)),
+                    accelerate_steps_float = (nominal_rate_sq - sq(initial_rate)) / (2 * accel),
+                    decelerate_steps_float = (nominal_rate_sq - sq(final_rate)) / (2 * accel);
+        float accelerate_steps = CEIL(accelerate_steps_float), decelerate_steps = FLOOR(decelerate_steps_float);
+        if (count - accelerate_steps - decelerate_steps < 0) {
+          accelerate_steps = constrain(CEIL((count + accelerate_steps_float - decelerate_steps_float) * 0.5f), 0.0f, count);
+          decelerate_steps = count - accelerate_steps;
+        }
+
+        calculate_trapezoid_for_block(block, to_speed_sqr(sq(ve)), to_speed_sqr(sq(vx)));
+
+        const float rate_err = _MAX(ABS(block->initial_rate - initial_rate), ABS(block->final_rate - final_rate)),
+                    steps_err = _MAX(ABS(block->accelerate_until - accelerate_steps), ABS(block->decelerate_after - (count - decelerate_steps)));
+        NOLESS(max_rate_err, rate_err);
+        NOLESS(max_steps_err, steps_err);
+        if (rate_err > 1 + 0.001f * block->nominal_rate || steps_err > 1 + 0.001f * count) fails++;
+        cases++;
+      }
+    }
+
+    SERIAL_ECHOLNPGM("Planner fixed point: ", cases, " cases, max rate error ", max_rate_err, " steps/s, max ramp error ", max_steps_err, " steps. ", fails ? F("FAIL") : F("PASS"));
+  }
+
+#endif
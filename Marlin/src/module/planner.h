@@ -116,6 +116,9 @@ enum BlockFlagBit {
 
   // Sync laser power from a queued block
   OPTARG(LASER_POWER_SYNC, BLOCK_BIT_LASER_PWR)
+
+  // A G2/G3 arc traced by FT_MOTION
+  OPTARG(ARC_NATIVE_BLOCKS, BLOCK_BIT_ARC)
 };
 
 /**
@@ -145,6 +148,10 @@ typedef struct {
       #if ENABLED(LASER_POWER_SYNC)
         bool sync_laser_pwr:1;
       #endif
+
+      #if ENABLED(ARC_NATIVE_BLOCKS)
+        bool arc:1;
+      #endif
     };
   };
 
@@ -179,11 +186,73 @@ typedef struct {
 
 #endif
 
+#if ENABLED(ARC_NATIVE_BLOCKS)
+
+  /**
+   * The circular part of an arc block. The other axes move linearly.
+   * The radius vector runs from the center to the start of the arc.
+   */
+  typedef struct {
+    AxisEnum axis_p, axis_q;                          // The plane of the arc
+    xy_float_t r_p, r_q;                              // Radius vector in steps of the P and Q axes
+    float angle;                                      // Angular travel in radians, positive counter-clockwise
+  } block_arc_t;
+
+#endif
+
+/**
+ * struct block_plan_t
+ *
+ * The speeds of a block that only the lookahead uses.
+ * The stepper never reads these, so they are kept apart from
+ * block_t and only for the last BLOCK_PLAN_SIZE blocks.
+ */
+#if ENABLED(PLANNER_FIXED_POINT)
+  // Speed squared in (mm/sec)^2 as 20.12 fixed point, saturating at 1024mm/sec
+  typedef uint32_t speed_sqr_t;
+  #define SPEED_SQR_FRACT 12
+  FORCE_INLINE speed_sqr_t to_speed_sqr(const_float_t v_sqr) {
+    return v_sqr < float(_BV32(32 - (SPEED_SQR_FRACT))) ? uint32_t(v_sqr * _BV32(SPEED_SQR_FRACT) + 0.5f) : UINT32_MAX;
+  }
+#else
+  typedef float speed_sqr_t;
+  #define to_speed_sqr(V) (V)
+#endif
+
+typedef struct {
+  float nominal_speed;                      // The nominal speed for this block in (mm/sec)
+  speed_sqr_t entry_speed_sqr,              // Entry speed at previous-current junction in (mm/sec)^2
+              max_entry_speed_sqr;          // Maximum allowable junction entry speed in (mm/sec)^2
+  float millimeters,                        // The total travel of this block in mm
+        acceleration;                       // acceleration mm/sec^2
+  #if ENABLED(PLANNER_FIXED_POINT)
+    speed_sqr_t accel_speed_sqr;            // The speed^2 change over the whole block (2 * acceleration * millimeters)
+    uint32_t rate_per_speed;                // nominal_rate / nominal_speed as 16.16 fixed point, in steps/mm
+  #endif
+} block_plan_t;
+
+#if HAS_RAMP_TABLE
+
+  /**
+   * An S-Curve speed ramp as linear pieces of 2^piece_bits timer ticks.
+   * The rate after the last piece is on the line to the end of the ramp,
+   * so the stepper must stop at the ramp's end rate.
+   */
+  typedef struct {
+    uint8_t piece_bits,                             // Each piece is 2^piece_bits STEP timer counts
+            pieces,                                 // The number of pieces. After the last the ramp is done.
+            shift[S_CURVE_RAMP_PIECES + 1];         // Steps per ISR in each piece (and when done) as a power of 2
+    uint32_t rate[S_CURVE_RAMP_PIECES + 1];         // Step rate at the start of each piece (and past the end)
+  } ramp_table_t;
+
+#endif
+
 /**
  * struct block_t
  *
  * A single entry in the planner buffer.
  * Tracks linear movement over multiple axes.
+ * The fields used for planning are in block_plan_t.
  *
  * The "nominal" values are as-specified by G-code, and
  * may never actually be reached due to acceleration limits.
@@ -197,13 +266,7 @@ typedef struct PlannerBlock {
   bool is_sync() { return flag.sync_position || is_fan_sync() || is_pwr_sync(); }
   bool is_page() { return TERN0(DIRECT_STEPPING, flag.page); }
   bool is_move() { return !(is_sync() || is_page()); }
-
-  // Fields used by the motion planner to manage acceleration
-  float nominal_speed,                      // The nominal speed for this block in (mm/sec)
-        entry_speed_sqr,                    // Entry speed at previous-current junction in (mm/sec)^2
-        max_entry_speed_sqr,                // Maximum allowable junction entry speed in (mm/sec)^2
-        millimeters,                        // The total travel of this block in mm
-        acceleration;                       // acceleration mm/sec^2
+  bool is_arc() { return TERN0(ARC_NATIVE_BLOCKS, flag.arc); }
 
   union {
     abce_ulong_t steps;                     // Step count along each axis
@@ -225,7 +288,11 @@ typedef struct PlannerBlock {
   uint32_t accelerate_until,                // The index of the step event on which to stop acceleration
            decelerate_after;                // The index of the step event on which to start decelerating
 
-  #if ENABLED(S_CURVE_ACCELERATION)
+  #if HAS_RAMP_TABLE
+    uint32_t cruise_rate;                   // The actual cruise rate to use, between end of the acceleration phase and start of deceleration phase
+    ramp_table_t accel_ramp,                // The speed ramps, for the Stepper ISR to interpolate
+                 decel_ramp;
+  #elif ENABLED(S_CURVE_ACCELERATION)
     uint32_t cruise_rate,                   // The actual cruise rate to use, between end of the acceleration phase and start of deceleration phase
              acceleration_time,             // Acceleration time and deceleration time in STEP timer counts
              deceleration_time,
@@ -279,6 +346,10 @@ typedef struct PlannerBlock {
     block_laser_t laser;
   #endif
 
+  #if ENABLED(ARC_NATIVE_BLOCKS)
+    block_arc_t arc;                        // Arc geometry, if flag.arc is set
+  #endif
+
   void reset() { memset((char*)this, 0, sizeof(*this)); }
 
 } block_t;
@@ -288,6 +359,7 @@ typedef struct PlannerBlock {
 #endif
 
 #define BLOCK_MOD(n) ((n)&(BLOCK_BUFFER_SIZE-1))
+#define PLAN_MOD(n) ((n)&(BLOCK_PLAN_SIZE-1))
 
 #if ENABLED(LASER_FEATURE)
   typedef struct {
@@ -350,8 +422,10 @@ typedef struct {
   typedef IF<(BLOCK_BUFFER_SIZE > 64), uint16_t, uint8_t>::type last_move_t;
 #endif
 
-#if ENABLED(ARC_SUPPORT)
+#if EITHER(ARC_SUPPORT, BEZIER_CURVE_SUPPORT)
   #define HINTS_CURVE_RADIUS
+#endif
+#if ENABLED(ARC_SUPPORT)
   #define HINTS_SAFE_EXIT_SPEED
 #endif
 
@@ -370,6 +444,13 @@ struct PlannerHints {
                                       // i.e., at or below the exit speed of the segment that the planner
                                       // would calculate if it knew the as-yet-unbuffered path
   #endif
+  #if ENABLED(ARC_NATIVE_BLOCKS)
+    const struct arc_hint_t {
+      AxisEnum axis_p, axis_q;        // The plane of the arc
+      ab_float_t rvec;                // Radius vector from the center to the start, in mm
+      float angle;                    // Angular travel in radians, positive counter-clockwise
+    } *arc = nullptr;                 // Make the move a single arc block
+  #endif
 
   PlannerHints(const_float_t mm=0.0f) : millimeters(mm) {}
 };
@@ -391,6 +472,26 @@ class Planner {
      *  Reader of tail is Stepper::isr(). Always consider tail busy / read-only
      */
     static block_t block_buffer[BLOCK_BUFFER_SIZE];
+
+    /**
+     * The planning records of the blocks, indexed like block_buffer.
+     *
+     * Only the last BLOCK_PLAN_SIZE blocks have a record. Before a new block
+     * reuses the record of an older one, block_buffer_planned is moved past
+     * that block. Its speeds are then final, which is always safe since the
+     * lookahead only ever raises them.
+     */
+    static block_plan_t plan_buffer[BLOCK_PLAN_SIZE];
+    FORCE_INLINE static block_plan_t& plan_of(const block_t * const block) { return plan_buffer[PLAN_MOD(block - block_buffer)]; }
+
+    // The oldest block that still has a planning record
+    FORCE_INLINE static uint8_t plan_tail() {
+      #if BLOCK_PLAN_SIZE < BLOCK_BUFFER_SIZE
+        if (BLOCK_MOD(block_buffer_head - block_buffer_tail) > BLOCK_PLAN_SIZE)
+          return BLOCK_MOD(block_buffer_head - (BLOCK_PLAN_SIZE));
+      #endif
+      return block_buffer_tail;
+    }
     static volatile uint8_t block_buffer_head,      // Index of the next block to be pushed
                             block_buffer_nonbusy,   // Index of the first non busy block
                             block_buffer_planned,   // Index of the optimally planned block
@@ -764,6 +865,12 @@ class Planner {
       // Wait until there are enough slots free
       while (moves_free() < count) { idle(); }
 
+      #if BLOCK_PLAN_SIZE < BLOCK_BUFFER_SIZE
+        // Finish planning the blocks whose records the new blocks will use
+        if (BLOCK_MOD(block_buffer_head + count - block_buffer_planned) > BLOCK_PLAN_SIZE)
+          block_buffer_planned = BLOCK_MOD(block_buffer_head + count - (BLOCK_PLAN_SIZE));
+      #endif
+
       // Return the first available block
       next_buffer_head = next_block_index(block_buffer_head);
       return &block_buffer[block_buffer_head];
@@ -787,6 +894,13 @@ class Planner {
       , feedRate_t fr_mm_s, const uint8_t extruder, const PlannerHints &hints
     );
 
+    #if ENABLED(COALESCE_SEGMENTS)
+      // Hold a segment for coalesce_line or coalesce_segment. 'p' is where the planner will step to.
+      static bool coalesce(const xyze_pos_t &p, const xyze_pos_t &target, const bool segment
+        , const_feedRate_t fr_mm_s, const uint8_t extruder, const PlannerHints &hints
+      );
+    #endif
+
     /**
      * @brief Populate a block in preparation for insertion
      * @details Populate the fields of a new linear movement block
@@ -860,6 +974,33 @@ class Planner {
       , const PlannerHints &hints=PlannerHints()
     );
 
+    /**
+     * Add a segment of a longer move, for buffer_line or buffer_segment.
+     * With COALESCE_SEGMENTS runs of nearly collinear segments are held
+     * back and buffered as one line. Call coalesce_flush() after the last.
+     */
+    #if ENABLED(COALESCE_SEGMENTS)
+      static bool coalesce_line(const xyze_pos_t &cart, const_feedRate_t fr_mm_s
+        , const uint8_t extruder=active_extruder
+        , const PlannerHints &hints=PlannerHints()
+      );
+      #if !IS_KINEMATIC
+        static bool coalesce_segment(const abce_pos_t &abce, const_feedRate_t fr_mm_s, const uint8_t extruder=active_extruder);
+      #endif
+      static bool coalesce_flush();
+    #else
+      FORCE_INLINE static bool coalesce_line(const xyze_pos_t &cart, const_feedRate_t fr_mm_s
+        , const uint8_t extruder=active_extruder
+        , const PlannerHints &hints=PlannerHints()
+      ) { return buffer_line(cart, fr_mm_s, extruder, hints); }
+      #if !IS_KINEMATIC
+        FORCE_INLINE static bool coalesce_segment(const abce_pos_t &abce, const_feedRate_t fr_mm_s, const uint8_t extruder=active_extruder) {
+          return buffer_segment(abce, fr_mm_s, extruder);
+        }
+      #endif
+      static bool coalesce_flush() { return true; }
+    #endif
+
     #if ENABLED(DIRECT_STEPPING)
       static void buffer_page(const page_idx_t page_idx, const uint8_t extruder, const uint16_t num_steps);
     #endif
@@ -935,6 +1076,10 @@ class Planner {
     // Block until all buffered steps are executed / cleaned
     static void synchronize();
 
+    #if BOTH(PLANNER_FIXED_POINT, MARLIN_TEST_BUILD)
+      static void test_fixed_point();
+    #endif
+
     // Wait for moves to finish and disable all steppers
     static void finish_and_disable();
 
@@ -971,6 +1116,10 @@ class Planner {
       static void clear_block_buffer_runtime();
     #endif
 
+    #if ENABLED(MPC_FLOW_FEEDFORWARD)
+      static float upcoming_e_speed(const uint8_t hotend, const_float_t seconds);
+    #endif
+
     #if ENABLED(AUTOTEMP)
       static celsius_t autotemp_min, autotemp_max;
       static float autotemp_factor;
@@ -1013,6 +1162,16 @@ class Planner {
       return target_velocity_sqr - 2 * accel * distance;
     }
 
+    // The same, for the whole of a planned block
+    static speed_sqr_t max_allowable_speed_sqr(const block_plan_t &plan, const speed_sqr_t target_velocity_sqr) {
+      #if ENABLED(PLANNER_FIXED_POINT)
+        const speed_sqr_t v_sqr = target_velocity_sqr + plan.accel_speed_sqr;
+        return v_sqr < target_velocity_sqr ? UINT32_MAX : v_sqr;
+      #else
+        return max_allowable_speed_sqr(-plan.acceleration, target_velocity_sqr, plan.millimeters);
+      #endif
+    }
+
     #if EITHER(S_CURVE_ACCELERATION, LIN_ADVANCE)
       /**
        * Calculate the speed reached given initial speed, acceleration and distance
@@ -1022,7 +1181,11 @@ class Planner {
       }
     #endif
 
-    static void calculate_trapezoid_for_block(block_t * const block, const_float_t entry_factor, const_float_t exit_factor);
+    #if ENABLED(PLANNER_FIXED_POINT)
+      static void calculate_trapezoid_for_block(block_t * const block, const speed_sqr_t entry_speed_sqr, const speed_sqr_t exit_speed_sqr);
+    #else
+      static void calculate_trapezoid_for_block(block_t * const block, const_float_t entry_factor, const_float_t exit_factor);
+    #endif
 
     static void reverse_pass_kernel(block_t * const current, const block_t * const next OPTARG(ARC_SUPPORT, const_float_t safe_exit_speed_sqr));
     static void forward_pass_kernel(const block_t * const previous, block_t * const current, uint8_t block_index);
@@ -37,10 +37,12 @@
 #include "../MarlinCore.h"
 #include "../gcode/queue.h"
 
-// See the meaning in the documentation of cubic_b_spline().
-#define MIN_STEP 0.002f
-#define MAX_STEP 0.1f
-#define SIGMA 0.1f
+#ifndef BEZIER_TOLERANCE
+  #define BEZIER_TOLERANCE 0.01f    // (mm)
+#endif
+#ifndef BEZIER_MIN_SEGMENT_MM
+  #define BEZIER_MIN_SEGMENT_MM 0.1f
+#endif
 
 // Compute the linear interpolation between two real numbers.
 static inline float interp(const_float_t a, const_float_t b, const_float_t t) { return (1 - t) * a + t * b; }
@@ -61,49 +63,20 @@ static inline float eval_bezier(const_float_t a, const_float_t b, const_float_t
 }
 
 /**
- * We approximate Euclidean distance with the sum of the coordinates
- * offset (so-called "norm 1"), which is quicker to compute.
- */
-static inline float dist1(const_float_t x1, const_float_t y1, const_float_t x2, const_float_t y2) { return ABS(x1 - x2) + ABS(y1 - y2); }
-
-/**
- * The algorithm for computing the step is loosely based on the one in Kig
- * (See https://sources.debian.net/src/kig/4:15.08.3-1/misc/kigpainter.cpp/#L759)
- * However, we do not use the stack.
- *
- * The algorithm goes as it follows: the parameters t runs from 0.0 to
- * 1.0 describing the curve, which is evaluated by eval_bezier(). At
- * each iteration we have to choose a step, i.e., the increment of the
- * t variable. By default the step of the previous iteration is taken,
- * and then it is enlarged or reduced depending on how straight the
- * curve locally is. The step is always clamped between MIN_STEP/2 and
- * 2*MAX_STEP. MAX_STEP is taken at the first iteration.
+ * The curve is split into chords no farther than BEZIER_TOLERANCE from
+ * the curve, so gentle curves get few long segments and tight ones get
+ * many short segments.
  *
- * For some t, the step value is considered acceptable if the curve in
- * the interval [t, t+step] is sufficiently straight, i.e.,
- * sufficiently close to linear interpolation. In practice the
- * following test is performed: the distance between eval_bezier(...,
- * t+step/2) is evaluated and compared with 0.5*(eval_bezier(...,
- * t)+eval_bezier(..., t+step)). If it is smaller than SIGMA, then the
- * step value is considered acceptable, otherwise it is not. The code
- * seeks to find the larger step value which is considered acceptable.
+ * For a step h of the parameter t, the distance between the curve and the
+ * chord is at most h^2/8 times the largest |B''| within the step. For a
+ * cubic B'' is linear in t, so |B''| is largest at one end of the step and
+ * the bound costs two evaluations. Each step starts from the rest of the
+ * curve and shrinks until the bound holds, but never below the parameter
+ * length of BEZIER_MIN_SEGMENT_MM at the current speed |B'|.
  *
- * At every iteration the recorded step value is considered and then
- * iteratively halved until it becomes acceptable. If it was already
- * acceptable in the beginning (i.e., no halving were done), then
- * maybe it was necessary to enlarge it; then it is iteratively
- * doubled while it remains acceptable. The last acceptable value
- * found is taken, provided that it is between MIN_STEP and MAX_STEP
- * and does not bring t over 1.0.
- *
- * Caveat: this algorithm is not perfect, since it can happen that a
- * step is considered acceptable even when the curve is not linear at
- * all in the interval [t, t+step] (but its mid point coincides "by
- * chance" with the midpoint according to the parametrization). This
- * kind of glitches can be eliminated with proper first derivative
- * estimates; however, given the improbability of such configurations,
- * the mitigation offered by MIN_STEP and the small computational
- * power available on Arduino, I think it is not wise to implement it.
+ * Each segment after the first also hints the radius of curvature at its
+ * start, |B'|^3 / |B' x B''|, so the junction speed follows the curve and
+ * not the angle between its chords.
  */
 void cubic_b_spline(
   const xyze_pos_t &position,       // current position
@@ -115,9 +88,19 @@ void cubic_b_spline(
   // Absolute first and second control points are recovered.
   const xy_pos_t first = position + offsets[0], second = target + offsets[1];
 
+  // Differences of the control points for the derivatives:
+  //   B'(t)  = 3 * ((1-t)^2 * d0 + 2(1-t)t * d1 + t^2 * d2)
+  //   B''(t) = 6 * ((1-t) * a0 + t * a1)
+  const xy_float_t d0 = first - position, d1 = second - first, d2 = target - second,
+                   a0 = d1 - d0, a1 = d2 - d1;
+  auto velocity = [&](const float t) -> xy_float_t {
+    const float u = 1 - t;
+    return (d0 * (u * u) + d1 * (2 * u * t) + d2 * (t * t)) * 3;
+  };
+  auto accel = [&](const float t) -> xy_float_t { return (a0 * (1 - t) + a1 * t) * 6; };
+
   xyze_pos_t bez_target;
   bez_target.set(position.x, position.y);
-  float step = MAX_STEP;
 
   millis_t next_idle_ms = millis() + 200UL;
 
@@ -133,61 +116,35 @@ void cubic_b_spline(
       idle();
     }
 
-    // First try to reduce the step in order to make it sufficiently
-    // close to a linear interpolation.
-    bool did_reduce = false;
-    float new_t = t + step;
-    NOMORE(new_t, 1);
-    float new_pos0 = eval_bezier(position.x, first.x, second.x, target.x, new_t),
-          new_pos1 = eval_bezier(position.y, first.y, second.y, target.y, new_t);
-    for (;;) {
-      if (new_t - t < (MIN_STEP)) break;
-      const float candidate_t = 0.5f * (t + new_t),
-                  candidate_pos0 = eval_bezier(position.x, first.x, second.x, target.x, candidate_t),
-                  candidate_pos1 = eval_bezier(position.y, first.y, second.y, target.y, candidate_t),
-                  interp_pos0 = 0.5f * (bez_target.x + new_pos0),
-                  interp_pos1 = 0.5f * (bez_target.y + new_pos1);
-      if (dist1(candidate_pos0, candidate_pos1, interp_pos0, interp_pos1) <= (SIGMA)) break;
-      new_t = candidate_t;
-      new_pos0 = candidate_pos0;
-      new_pos1 = candidate_pos1;
-      did_reduce = true;
-    }
+    const xy_float_t vel = velocity(t), acc = accel(t);
+    const float speed = vel.magnitude(), acc_t = acc.magnitude(),
+                min_step = speed > 0 ? (BEZIER_MIN_SEGMENT_MM) / speed : 1;
 
-    // If we did not reduce the step, maybe we should enlarge it.
-    if (!did_reduce) for (;;) {
-      if (new_t - t > MAX_STEP) break;
-      const float candidate_t = t + 2 * (new_t - t);
-      if (candidate_t >= 1) break;
-      const float candidate_pos0 = eval_bezier(position.x, first.x, second.x, target.x, candidate_t),
-                  candidate_pos1 = eval_bezier(position.y, first.y, second.y, target.y, candidate_t),
-                  interp_pos0 = 0.5f * (bez_target.x + candidate_pos0),
-                  interp_pos1 = 0.5f * (bez_target.y + candidate_pos1);
-      if (dist1(new_pos0, new_pos1, interp_pos0, interp_pos1) > (SIGMA)) break;
-      new_t = candidate_t;
-      new_pos0 = candidate_pos0;
-      new_pos1 = candidate_pos1;
+    // Take the longest step within the tolerance
+    float step = 1 - t;
+    while (step > min_step) {
+      const float acc_max = _MAX(acc_t, accel(t + step).magnitude());
+      if (sq(step) * acc_max <= 8 * (BEZIER_TOLERANCE)) break;
+      step = 0.95f * SQRT(8 * (BEZIER_TOLERANCE) / acc_max);
     }
+    NOLESS(step, min_step);
 
-    // Check some postcondition; they are disabled in the actual
-    // Marlin build, but if you test the same code on a computer you
-    // may want to check they are respect.
-    /*
-      assert(new_t <= 1.0);
-      if (new_t < 1.0) {
-        assert(new_t - t >= (MIN_STEP) / 2.0);
-        assert(new_t - t <= (MAX_STEP) * 2.0);
+    #if ENABLED(HINTS_CURVE_RADIUS)
+      // The junction with the previous move is a corner. Later junctions are on the curve.
+      if (t > 0) {
+        const float cross = ABS(vel.x * acc.y - vel.y * acc.x);
+        hints.curve_radius = cross > 0 ? sq(speed) * speed / cross : 0;
       }
-    */
+    #endif
 
-    hints.millimeters = new_t - t;
-    t = new_t;
+    t += step;
+    if (t > 0.9999f) t = 1;
 
     // Compute and send new position
     xyze_pos_t new_bez = LOGICAL_AXIS_ARRAY(
       interp(position.e, target.e, t),  // FIXME. Wrong, since t is not linear in the distance.
-      new_pos0,
-      new_pos1,
+      eval_bezier(position.x, first.x, second.x, target.x, t),
+      eval_bezier(position.y, first.y, second.y, target.y, t),
       interp(position.z, target.z, t),  // FIXME. Wrong, since t is not linear in the distance.
       interp(position.i, target.i, t),  // FIXME. Wrong, since t is not linear in the distance.
       interp(position.j, target.j, t),  // FIXME. Wrong, since t is not linear in the distance.
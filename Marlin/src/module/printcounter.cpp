@@ -91,6 +91,18 @@ millis_t PrintCounter::deltaDuration() {
   }
 #endif
 
+#if BOTH(HAS_BAFSD, BAFSD_PROFILE)
+  void PrintCounter::incToolChange(const millis_t ms) {
+    TERN_(DEBUG_PRINTCOUNTER, debug(PSTR("incToolChange")));
+
+    // Refuses to update data if object is not loaded
+    if (!isLoaded()) return;
+
+    data.toolChanges++;
+    data.toolChangeTime += ms;
+  }
+#endif
+
 void PrintCounter::initStats() {
   TERN_(DEBUG_PRINTCOUNTER, debug(PSTR("initStats")));
 
@@ -111,11 +123,15 @@ void PrintCounter::initStats() {
     #if SERVICE_INTERVAL_3 > 0
       , .nextService3 = SERVICE_INTERVAL_SEC_3
     #endif
+    #if BOTH(HAS_BAFSD, BAFSD_PROFILE)
+      , .toolChanges = 0
+      , .toolChangeTime = 0
+    #endif
   };
 
   saveStats();
   persistentStore.access_start();
-  persistentStore.write_data(address, (uint8_t)0x16);
+  persistentStore.write_data(address, (uint8_t)STATS_EEPROM_MAGIC);
   persistentStore.access_finish();
 }
 
@@ -138,7 +154,7 @@ void PrintCounter::loadStats() {
   uint8_t value = 0;
   persistentStore.access_start();
   persistentStore.read_data(address, &value, sizeof(uint8_t));
-  if (value != 0x16)
+  if (value != STATS_EEPROM_MAGIC)
     initStats();
   else
     persistentStore.read_data(address + sizeof(uint8_t), (uint8_t*)&data, sizeof(printStatistics));
@@ -221,6 +237,13 @@ void PrintCounter::showStats() {
     SERIAL_CHAR('m');
   #endif
 
+  #if BOTH(HAS_BAFSD, BAFSD_PROFILE)
+    elapsed = data.toolChangeTime / 1000;
+    elapsed.toString(buffer);
+    SERIAL_ECHOPGM("\n" STR_STATS "Tool changes: ", data.toolChanges, ", Time: ", buffer);
+    if (data.toolChanges) SERIAL_ECHOPGM(", Average: ", data.toolChangeTime / data.toolChanges, "ms");
+  #endif
+
   SERIAL_EOL();
 
   #if SERVICE_INTERVAL_1 > 0
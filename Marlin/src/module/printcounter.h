@@ -31,8 +31,15 @@
 // Round up I2C / SPI address to next page boundary (assuming 32 byte pages)
 #define STATS_EEPROM_ADDRESS TERN(USE_WIRED_EEPROM, 0x40, 0x32)
 
-struct printStatistics {    // 16 bytes
-  //const uint8_t magic;    // Magic header, it will always be 0x16
+// Magic header. A different layout gets a new value, so the old data isn't misread.
+#if BOTH(HAS_BAFSD, BAFSD_PROFILE)
+  #define STATS_EEPROM_MAGIC 0x17
+#else
+  #define STATS_EEPROM_MAGIC 0x16
+#endif
+
+struct printStatistics {    // 16 bytes, plus 4 per service interval and 8 with BAFSD_PROFILE
+  //const uint8_t magic;    // Magic header, STATS_EEPROM_MAGIC
   uint16_t totalPrints;     // Number of prints
   uint16_t finishedPrints;  // Number of complete prints
   uint32_t printTime;       // Accumulated printing time
@@ -49,6 +56,10 @@ struct printStatistics {    // 16 bytes
   #if SERVICE_INTERVAL_3 > 0
     uint32_t nextService3;
   #endif
+  #if BOTH(HAS_BAFSD, BAFSD_PROFILE)
+    uint32_t toolChanges;     // BAFS port swaps
+    uint32_t toolChangeTime;  // Accumulated swap time in ms
+  #endif
 };
 
 class PrintCounter: public Stopwatch {
@@ -131,6 +142,16 @@ class PrintCounter: public Stopwatch {
       static void incFilamentUsed(float const &amount);
     #endif
 
+    #if BOTH(HAS_BAFSD, BAFSD_PROFILE)
+      /**
+       * @brief Count a tool change
+       * @details Increment the tool change counter and add the time it took
+       *
+       * @param ms The duration of the tool change in ms
+       */
+      static void incToolChange(const millis_t ms);
+    #endif
+
     /**
      * @brief Reset the Print Statistics
      * @details Reset the statistics to zero and saves them to EEPROM creating
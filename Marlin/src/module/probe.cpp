@@ -94,6 +94,10 @@
   #include "../feature/x_twist.h"
 #endif
 
+#if ENABLED(FT_MOTION)
+  #include "ft_motion.h"
+#endif
+
 #if ENABLED(EXTENSIBLE_UI)
   #include "../lcd/extui/ui_api.h"
 #elif ENABLED(DWIN_LCD_PROUI)
@@ -873,6 +877,9 @@ float Probe::probe_at_point(const_float_t rx, const_float_t ry, const ProbePtRai
     DEBUG_POS("", current_position);
   }
 
+  // Probing needs the endstops, which only the trapezoid ISR checks
+  TERN_(FT_MOTION, FTMotionDisableInScope FT_Disabler);
+
   #if ENABLED(BLTOUCH)
     if (bltouch.high_speed_mode && bltouch.triggered())
       bltouch._reset();
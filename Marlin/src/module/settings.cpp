@@ -128,6 +128,14 @@
   void M217_report(const bool eeprom);
 #endif
 
+#if HAS_BAFSD && ANY(BAFSD_LEARN_SWITCH_TIME, BAFSD_ODOMETER, BAFSD_FAILOVER)
+  #include "../feature/mmu/bafsd.h"
+#endif
+
+#if ENABLED(FT_MOTION)
+  #include "ft_motion.h"
+#endif
+
 #if ENABLED(BLTOUCH)
   #include "../feature/bltouch.h"
 #endif
@@ -587,10 +595,43 @@ typedef struct SettingsDataStruct {
   #if ENABLED(INPUT_SHAPING_X)
     float shaping_x_frequency, // M593 X F
           shaping_x_zeta;      // M593 X D
+    uint8_t shaping_x_type;    // M593 X T
   #endif
   #if ENABLED(INPUT_SHAPING_Y)
     float shaping_y_frequency, // M593 Y F
           shaping_y_zeta;      // M593 Y D
+    uint8_t shaping_y_type;    // M593 Y T
+  #endif
+  #if ENABLED(INPUT_SHAPING_Z)
+    float shaping_z_frequency, // M593 Z F
+          shaping_z_zeta;      // M593 Z D
+    uint8_t shaping_z_type;    // M593 Z T
+  #endif
+  #if ENABLED(INPUT_SHAPING_E)
+    float shaping_e_frequency, // M593 E F
+          shaping_e_zeta;      // M593 E D
+    uint8_t shaping_e_type;    // M593 E T
+  #endif
+
+  //
+  // Fixed-Time Motion
+  //
+  #if ENABLED(FT_MOTION)
+    bool ftm_active;           // M493 S
+  #endif
+
+  //
+  // BAFS switch times
+  //
+  #if ENABLED(BAFSD_LEARN_SWITCH_TIME)
+    uint16_t bafsd_switch_time[EXTRUDERS][EXTRUDERS]; // M711 P T S
+  #endif
+
+  //
+  // BAFS backup ports
+  //
+  #if ENABLED(BAFSD_FAILOVER)
+    int8_t bafsd_backup[EXTRUDERS];                   // M714 P B
   #endif
 
 } SettingsData;
@@ -1652,13 +1693,53 @@ void MarlinSettings::postprocess() {
       #if ENABLED(INPUT_SHAPING_X)
         EEPROM_WRITE(stepper.get_shaping_frequency(X_AXIS));
         EEPROM_WRITE(stepper.get_shaping_damping_ratio(X_AXIS));
+        _FIELD_TEST(shaping_x_type);
+        EEPROM_WRITE(uint8_t(stepper.get_shaping_type(X_AXIS)));
       #endif
       #if ENABLED(INPUT_SHAPING_Y)
         EEPROM_WRITE(stepper.get_shaping_frequency(Y_AXIS));
         EEPROM_WRITE(stepper.get_shaping_damping_ratio(Y_AXIS));
+        _FIELD_TEST(shaping_y_type);
+        EEPROM_WRITE(uint8_t(stepper.get_shaping_type(Y_AXIS)));
+      #endif
+      #if ENABLED(INPUT_SHAPING_Z)
+        EEPROM_WRITE(stepper.get_shaping_frequency(Z_AXIS));
+        EEPROM_WRITE(stepper.get_shaping_damping_ratio(Z_AXIS));
+        _FIELD_TEST(shaping_z_type);
+        EEPROM_WRITE(uint8_t(stepper.get_shaping_type(Z_AXIS)));
+      #endif
+      #if ENABLED(INPUT_SHAPING_E)
+        EEPROM_WRITE(stepper.get_shaping_frequency(E_AXIS));
+        EEPROM_WRITE(stepper.get_shaping_damping_ratio(E_AXIS));
+        _FIELD_TEST(shaping_e_type);
+        EEPROM_WRITE(uint8_t(stepper.get_shaping_type(E_AXIS)));
       #endif
     #endif
 
+    //
+    // Fixed-Time Motion
+    //
+    #if ENABLED(FT_MOTION)
+      _FIELD_TEST(ftm_active);
+      EEPROM_WRITE(FTMotion::active);
+    #endif
+
+    //
+    // BAFS switch times
+    //
+    #if ENABLED(BAFSD_LEARN_SWITCH_TIME)
+      _FIELD_TEST(bafsd_switch_time);
+      EEPROM_WRITE(bafsd.switch_time);
+    #endif
+
+    //
+    // BAFS backup ports
+    //
+    #if ENABLED(BAFSD_FAILOVER)
+      _FIELD_TEST(bafsd_backup);
+      EEPROM_WRITE(bafsd.backup);
+    #endif
+
     //
     // Report final CRC and Data Size
     //
@@ -2687,21 +2768,91 @@ void MarlinSettings::postprocess() {
       #if ENABLED(INPUT_SHAPING_X)
       {
         float _data[2];
+        uint8_t _type;
         EEPROM_READ(_data);
-        stepper.set_shaping_frequency(X_AXIS, _data[0]);
-        stepper.set_shaping_damping_ratio(X_AXIS, _data[1]);
+        _FIELD_TEST(shaping_x_type);
+        EEPROM_READ(_type);
+        if (!validating) {
+          stepper.set_shaping_frequency(X_AXIS, _data[0]);
+          stepper.set_shaping_damping_ratio(X_AXIS, _data[1]);
+          stepper.set_shaping_type(X_AXIS, ShaperType(_type));
+        }
       }
       #endif
 
       #if ENABLED(INPUT_SHAPING_Y)
       {
         float _data[2];
+        uint8_t _type;
         EEPROM_READ(_data);
-        stepper.set_shaping_frequency(Y_AXIS, _data[0]);
-        stepper.set_shaping_damping_ratio(Y_AXIS, _data[1]);
+        _FIELD_TEST(shaping_y_type);
+        EEPROM_READ(_type);
+        if (!validating) {
+          stepper.set_shaping_frequency(Y_AXIS, _data[0]);
+          stepper.set_shaping_damping_ratio(Y_AXIS, _data[1]);
+          stepper.set_shaping_type(Y_AXIS, ShaperType(_type));
+        }
+      }
+      #endif
+
+      #if ENABLED(INPUT_SHAPING_Z)
+      {
+        float _data[2];
+        uint8_t _type;
+        EEPROM_READ(_data);
+        _FIELD_TEST(shaping_z_type);
+        EEPROM_READ(_type);
+        if (!validating) {
+          stepper.set_shaping_frequency(Z_AXIS, _data[0]);
+          stepper.set_shaping_damping_ratio(Z_AXIS, _data[1]);
+          stepper.set_shaping_type(Z_AXIS, ShaperType(_type));
+        }
+      }
+      #endif
+
+      #if ENABLED(INPUT_SHAPING_E)
+      {
+        float _data[2];
+        uint8_t _type;
+        EEPROM_READ(_data);
+        _FIELD_TEST(shaping_e_type);
+        EEPROM_READ(_type);
+        if (!validating) {
+          stepper.set_shaping_frequency(E_AXIS, _data[0]);
+          stepper.set_shaping_damping_ratio(E_AXIS, _data[1]);
+          stepper.set_shaping_type(E_AXIS, ShaperType(_type));
+        }
+      }
+      #endif
+
+      //
+      // Fixed-Time Motion
+      //
+      #if ENABLED(FT_MOTION)
+      {
+        bool ftm_active;
+        _FIELD_TEST(ftm_active);
+        EEPROM_READ(ftm_active);
+        if (!validating) ftMotion.set_active(ftm_active);
       }
       #endif
 
+      //
+      // BAFS switch times
+      //
+      #if ENABLED(BAFSD_LEARN_SWITCH_TIME)
+        _FIELD_TEST(bafsd_switch_time);
+        EEPROM_READ(bafsd.switch_time);
+      #endif
+
+      //
+      // BAFS backup ports
+      //
+      #if ENABLED(BAFSD_FAILOVER)
+        _FIELD_TEST(bafsd_backup);
+        EEPROM_READ(bafsd.backup);
+      #endif
+
       //
       // Validate Final Size and CRC
       //
@@ -2833,7 +2984,7 @@ void MarlinSettings::postprocess() {
     uint16_t MarlinSettings::meshes_start_index() {
       // Pad the end of configuration data so it can float up
       // or down a little bit without disrupting the mesh data
-      return (datasize() + EEPROM_OFFSET + 32) & 0xFFF8;
+      return (datasize() + EEPROM_OFFSET + TERN0(BAFSD_ODOMETER, odometer_size()) + 32) & 0xFFF8;
     }
 
     #define MESH_STORE_SIZE sizeof(TERN(OPTIMIZED_MESH_STORAGE, mesh_store_t, bedlevel.z_values))
@@ -2944,6 +3095,60 @@ void MarlinSettings::postprocess() {
 
   #endif // AUTO_BED_LEVELING_UBL
 
+  #if ENABLED(BAFSD_ODOMETER)
+
+    /**
+     * The BAFS odometer follows the settings block with its own mark and CRC,
+     * so it's saved as filament is used and not only with M500.
+     */
+    #define ODOMETER_MARK (0x40 | EXTRUDERS)
+
+    uint16_t MarlinSettings::odometer_size() {
+      return sizeof(uint8_t) + sizeof(bafsd.spool_mm) + sizeof(bafsd.used_mm) + sizeof(uint16_t);
+    }
+
+    void MarlinSettings::store_odometer() {
+      bafsd.fold_steps();
+
+      int pos = EEPROM_OFFSET + datasize();
+      uint16_t crc = 0;
+      const uint8_t mark = ODOMETER_MARK;
+
+      persistentStore.access_start();
+      bool status = persistentStore.write_data(pos, &mark, sizeof(mark), &crc);
+      status |= persistentStore.write_data(pos, (uint8_t*)bafsd.spool_mm, sizeof(bafsd.spool_mm), &crc);
+      status |= persistentStore.write_data(pos, (uint8_t*)bafsd.used_mm, sizeof(bafsd.used_mm), &crc);
+      const uint16_t stored_crc = crc;
+      status |= persistentStore.write_data(pos, (uint8_t*)&stored_crc, sizeof(stored_crc), &crc);
+      persistentStore.access_finish();
+
+      if (status) SERIAL_ECHOLNPGM("?Unable to save BAFS odometer.");
+    }
+
+    bool MarlinSettings::load_odometer() {
+      float spool_mm[EXTRUDERS], used_mm[EXTRUDERS];
+      uint8_t mark = 0;
+      uint16_t stored_crc = 0;
+
+      int pos = EEPROM_OFFSET + datasize();
+      uint16_t crc = 0;
+
+      persistentStore.access_start();
+      persistentStore.read_data(pos, &mark, sizeof(mark), &crc);
+      persistentStore.read_data(pos, (uint8_t*)spool_mm, sizeof(spool_mm), &crc);
+      persistentStore.read_data(pos, (uint8_t*)used_mm, sizeof(used_mm), &crc);
+      const uint16_t data_crc = crc;
+      persistentStore.read_data(pos, (uint8_t*)&stored_crc, sizeof(stored_crc), &crc);
+      persistentStore.access_finish();
+
+      if (mark != ODOMETER_MARK || stored_crc != data_crc) return false;
+      COPY(bafsd.spool_mm, spool_mm);
+      COPY(bafsd.used_mm, used_mm);
+      return true;
+    }
+
+  #endif // BAFSD_ODOMETER
+
 #else // !EEPROM_SETTINGS
 
   bool MarlinSettings::save() {
@@ -3492,13 +3697,40 @@ void MarlinSettings::reset() {
     #if ENABLED(INPUT_SHAPING_X)
       stepper.set_shaping_frequency(X_AXIS, SHAPING_FREQ_X);
       stepper.set_shaping_damping_ratio(X_AXIS, SHAPING_ZETA_X);
+      stepper.set_shaping_type(X_AXIS, SHAPER_TYPE(SHAPING_TYPE_X));
     #endif
     #if ENABLED(INPUT_SHAPING_Y)
       stepper.set_shaping_frequency(Y_AXIS, SHAPING_FREQ_Y);
       stepper.set_shaping_damping_ratio(Y_AXIS, SHAPING_ZETA_Y);
+      stepper.set_shaping_type(Y_AXIS, SHAPER_TYPE(SHAPING_TYPE_Y));
+    #endif
+    #if ENABLED(INPUT_SHAPING_Z)
+      stepper.set_shaping_frequency(Z_AXIS, SHAPING_FREQ_Z);
+      stepper.set_shaping_damping_ratio(Z_AXIS, SHAPING_ZETA_Z);
+      stepper.set_shaping_type(Z_AXIS, SHAPER_TYPE(SHAPING_TYPE_Z));
+    #endif
+    #if ENABLED(INPUT_SHAPING_E)
+      stepper.set_shaping_frequency(E_AXIS, SHAPING_FREQ_E);
+      stepper.set_shaping_damping_ratio(E_AXIS, SHAPING_ZETA_E);
+      stepper.set_shaping_type(E_AXIS, SHAPER_TYPE(SHAPING_TYPE_E));
     #endif
   #endif
 
+  //
+  // Fixed-Time Motion
+  //
+  TERN_(FT_MOTION, ftMotion.set_active(ENABLED(FTM_DEFAULT_ENABLED)));
+
+  //
+  // BAFS switch times
+  //
+  TERN_(BAFSD_LEARN_SWITCH_TIME, bafsd.reset_switch_times());
+
+  //
+  // BAFS backup ports
+  //
+  TERN_(BAFSD_FAILOVER, bafsd.reset_backup_ports());
+
   postprocess();
 
   #if EITHER(EEPROM_CHITCHAT, DEBUG_LEVELING_FEATURE)
@@ -3751,6 +3983,26 @@ void MarlinSettings::reset() {
     //
     TERN_(HAS_SHAPING, gcode.M593_report(forReplay));
 
+    //
+    // Fixed-Time Motion
+    //
+    TERN_(FT_MOTION, gcode.M493_report(forReplay));
+
+    //
+    // BAFS switch times
+    //
+    TERN_(BAFSD_LEARN_SWITCH_TIME, gcode.M711_report(forReplay));
+
+    //
+    // BAFS filament odometer
+    //
+    TERN_(BAFSD_ODOMETER, gcode.M713_report(forReplay));
+
+    //
+    // BAFS backup ports
+    //
+    TERN_(BAFSD_FAILOVER, gcode.M714_report(forReplay));
+
     //
     // Linear Advance
     //
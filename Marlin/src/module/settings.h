@@ -84,6 +84,12 @@ class MarlinSettings {
         //static void defrag_meshes();  // "
       #endif
 
+      #if ENABLED(BAFSD_ODOMETER)
+        static uint16_t odometer_size();
+        static void store_odometer();   // Saved on its own, not with M500
+        static bool load_odometer();    // Return 'true' if the counts were loaded
+      #endif
+
     #else // !EEPROM_SETTINGS
 
       FORCE_INLINE
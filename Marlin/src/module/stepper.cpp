@@ -121,6 +121,21 @@ Stepper stepper; // Singleton
   #include "../feature/runout.h"
 #endif
 
+#if BOTH(HAS_BAFSD, BAFSD_ODOMETER)
+  #include "../feature/mmu/bafsd.h"
+#endif
+
+#if ENABLED(FT_MOTION)
+  #include "ft_motion.h"
+#endif
+
+#if ENABLED(STEPPER_ISR_PROFILE)
+  #include "stepper/isr_profile.h"
+  #define ISR_PHASE(P, V...) ISR_PROFILED(P, V)
+#else
+  #define ISR_PHASE(P, V...) V
+#endif
+
 #if ENABLED(AUTO_POWER_CONTROL)
   #include "../feature/power.h"
 #endif
@@ -212,7 +227,7 @@ uint32_t Stepper::advance_divisor = 0,
   constexpr uint8_t Stepper::stepper_extruder;
 #endif
 
-#if ENABLED(S_CURVE_ACCELERATION)
+#if ENABLED(S_CURVE_ACCELERATION) && !HAS_RAMP_TABLE
   int32_t __attribute__((used)) Stepper::bezier_A __asm__("bezier_A");    // A coefficient in Bézier speed curve with alias for assembler
   int32_t __attribute__((used)) Stepper::bezier_B __asm__("bezier_B");    // B coefficient in Bézier speed curve with alias for assembler
   int32_t __attribute__((used)) Stepper::bezier_C __asm__("bezier_C");    // C coefficient in Bézier speed curve with alias for assembler
@@ -233,25 +248,29 @@ uint32_t Stepper::advance_divisor = 0,
 #endif
 
 #if HAS_SHAPING
-  shaping_time_t      ShapingQueue::now = 0;
-  shaping_time_t      ShapingQueue::times[shaping_echoes];
-  shaping_echo_axis_t ShapingQueue::echo_axes[shaping_echoes];
-  uint16_t            ShapingQueue::tail = 0;
-
-  #if ENABLED(INPUT_SHAPING_X)
-    shaping_time_t  ShapingQueue::delay_x;
-    shaping_time_t  ShapingQueue::peek_x_val = shaping_time_t(-1);
-    uint16_t        ShapingQueue::head_x = 0;
-    uint16_t        ShapingQueue::_free_count_x = shaping_echoes - 1;
-    ShapeParams     Stepper::shaping_x;
-  #endif
-  #if ENABLED(INPUT_SHAPING_Y)
-    shaping_time_t  ShapingQueue::delay_y;
-    shaping_time_t  ShapingQueue::peek_y_val = shaping_time_t(-1);
-    uint16_t        ShapingQueue::head_y = 0;
-    uint16_t        ShapingQueue::_free_count_y = shaping_echoes - 1;
-    ShapeParams     Stepper::shaping_y;
-  #endif
+  shaping_time_t  ShapingQueue::now = 0;
+  shaping_time_t  ShapingQueue::times[shaping_echoes];
+  uint8_t         ShapingQueue::echo_axes[shaping_echoes];
+  uint16_t        ShapingQueue::tail = 0;
+
+  // Echo streams are set up by set_shaping_frequency
+  uint8_t         ShapingQueue::streams[NUM_SHAPED_AXES];
+  shaping_time_t  ShapingQueue::delay[NUM_SHAPED_AXES][SHAPING_ECHO_STREAMS];
+  shaping_time_t  ShapingQueue::peek_val[NUM_SHAPED_AXES][SHAPING_ECHO_STREAMS];
+  uint16_t        ShapingQueue::head[NUM_SHAPED_AXES][SHAPING_ECHO_STREAMS];
+  uint16_t        ShapingQueue::_free_count[NUM_SHAPED_AXES][SHAPING_ECHO_STREAMS];
+  ShapeParams     Stepper::shaping[NUM_SHAPED_AXES];
+
+  static_assert(NUM_SHAPED_AXES * 2 <= 8, "ShapingQueue holds the echoes of up to 4 axes.");
+
+  #define _SHAPING_ASSERTS(A) \
+    static_assert(shaper_impulses(SHAPER_TYPE(SHAPING_TYPE_##A)) <= SHAPING_MAX_IMPULSES, "SHAPING_TYPE_" STRINGIFY(A) " needs a larger SHAPING_MAX_IMPULSES."); \
+    static_assert((SHAPING_FREQ_##A) == 0 || float(uint32_t(STEPPER_TIMER_RATE) / 8) * shaper_span(SHAPER_TYPE(SHAPING_TYPE_##A)) / (SHAPING_FREQ_##A) < shaping_time_t(-2), "SHAPING_FREQ_" STRINGIFY(A) " is too low for SHAPING_TYPE_" STRINGIFY(A) ".");
+  TERN_(INPUT_SHAPING_X, _SHAPING_ASSERTS(X))
+  TERN_(INPUT_SHAPING_Y, _SHAPING_ASSERTS(Y))
+  TERN_(INPUT_SHAPING_Z, _SHAPING_ASSERTS(Z))
+  TERN_(INPUT_SHAPING_E, _SHAPING_ASSERTS(E))
+  #undef _SHAPING_ASSERTS
 #endif
 
 #if ENABLED(INTEGRATED_BABYSTEPPING)
@@ -635,7 +654,7 @@ void Stepper::set_directions() {
   DIR_WAIT_AFTER();
 }
 
-#if ENABLED(S_CURVE_ACCELERATION)
+#if ENABLED(S_CURVE_ACCELERATION) && !HAS_RAMP_TABLE
   /**
    *  This uses a quintic (fifth-degree) Bézier polynomial for the velocity curve, giving
    *  a "linear pop" velocity curve; with pop being the sixth derivative of position:
@@ -1438,7 +1457,7 @@ void Stepper::set_directions() {
       #endif
     }
   #endif
-#endif // S_CURVE_ACCELERATION
+#endif // S_CURVE_ACCELERATION && !HAS_RAMP_TABLE
 
 /**
  * Stepper Driver Interrupt
@@ -1462,6 +1481,8 @@ HAL_STEP_TIMER_ISR() {
 
 void Stepper::isr() {
 
+  TERN_(STEPPER_ISR_PROFILE, const uint32_t isr_start = isr_profile_count());
+
   static uint32_t nextMainISR = 0;  // Interval until the next main Stepper Pulse phase (0 = Now)
 
   #ifndef __AVR__
@@ -1487,13 +1508,21 @@ void Stepper::isr() {
     // Enable ISRs to reduce USART processing latency
     hal.isr_on();
 
-    TERN_(HAS_SHAPING, shaping_isr());                  // Do Shaper stepping, if needed
+    #if ENABLED(FT_MOTION)
+      if (FTMotion::active) {                           // Fixed-time motion replaces the pulse and block phases
+        if (!nextMainISR) ISR_PHASE(PH_FT_MOTION, nextMainISR = ft_motion_isr());
+      }
+      else
+    #endif
+    {
+      TERN_(HAS_SHAPING, ISR_PHASE(PH_SHAPING, shaping_isr())); // Do Shaper stepping, if needed
 
-    if (!nextMainISR) pulse_phase_isr();                // 0 = Do coordinated axes Stepper pulses
+      if (!nextMainISR) ISR_PHASE(PH_PULSE, pulse_phase_isr()); // 0 = Do coordinated axes Stepper pulses
+    }
 
     #if ENABLED(LIN_ADVANCE)
       if (!nextAdvanceISR) {                            // 0 = Do Linear Advance E Stepper pulses
-        advance_isr();
+        ISR_PHASE(PH_ADVANCE, advance_isr());
         nextAdvanceISR = la_interval;
       }
       else if (nextAdvanceISR == LA_ADV_NEVER)          // Start LA steps if necessary
@@ -1502,12 +1531,12 @@ void Stepper::isr() {
 
     #if ENABLED(INTEGRATED_BABYSTEPPING)
       const bool is_babystep = (nextBabystepISR == 0);  // 0 = Do Babystepping (XY)Z pulses
-      if (is_babystep) nextBabystepISR = babystepping_isr();
+      if (is_babystep) ISR_PHASE(PH_BABYSTEP, nextBabystepISR = babystepping_isr());
     #endif
 
     // ^== Time critical. NOTHING besides pulse generation should be above here!!!
 
-    if (!nextMainISR) nextMainISR = block_phase_isr();  // Manage acc/deceleration, get next block
+    if (!nextMainISR) ISR_PHASE(PH_BLOCK, nextMainISR = block_phase_isr()); // Manage acc/deceleration, get next block
 
     #if ENABLED(INTEGRATED_BABYSTEPPING)
       if (is_babystep)                                  // Avoid ANY stepping too soon after baby-stepping
@@ -1521,8 +1550,7 @@ void Stepper::isr() {
     const uint32_t interval = _MIN(
       uint32_t(HAL_TIMER_TYPE_MAX),                           // Come back in a very long time
       nextMainISR                                             // Time until the next Pulse / Block phase
-      OPTARG(INPUT_SHAPING_X, ShapingQueue::peek_x())         // Time until next input shaping echo for X
-      OPTARG(INPUT_SHAPING_Y, ShapingQueue::peek_y())         // Time until next input shaping echo for Y
+      OPTARG(HAS_SHAPING, ShapingQueue::peek())               // Time until the next input shaping echo
       OPTARG(LIN_ADVANCE, nextAdvanceISR)                     // Come back early for Linear Advance?
       OPTARG(INTEGRATED_BABYSTEPPING, nextBabystepISR)        // Come back early for Babystepping?
     );
@@ -1589,7 +1617,10 @@ void Stepper::isr() {
      * loop to 10 iterations. Beyond that, there's no way to ensure correct pulse
      * timing, since the MCU isn't fast enough.
      */
-    if (!--max_loops) next_isr_ticks = min_ticks;
+    if (!--max_loops) {
+      next_isr_ticks = min_ticks;
+      TERN_(STEPPER_ISR_PROFILE, ISRProfile::overruns++);
+    }
 
     // Advance pulses if not enough time to wait for the next ISR
   } while (next_isr_ticks < min_ticks);
@@ -1600,6 +1631,8 @@ void Stepper::isr() {
   // Set the next ISR to fire at the proper time
   HAL_timer_set_compare(MF_TIMER_STEP, hal_timer_t(next_isr_ticks));
 
+  TERN_(STEPPER_ISR_PROFILE, ISRProfile::add(ISRProfile::PH_ISR, isr_profile_count() - isr_start));
+
   // Don't forget to finally reenable interrupts on non-AVR.
   // AVR automatically calls sei() for us on Return-from-Interrupt.
   #ifndef __AVR__
@@ -1630,14 +1663,10 @@ void Stepper::pulse_phase_isr() {
       discard_current_block();
       #if HAS_SHAPING
         ShapingQueue::purge();
-        #if ENABLED(INPUT_SHAPING_X)
-          shaping_x.delta_error = 0;
-          shaping_x.last_block_end_pos = count_position.x;
-        #endif
-        #if ENABLED(INPUT_SHAPING_Y)
-          shaping_y.delta_error = 0;
-          shaping_y.last_block_end_pos = count_position.y;
-        #endif
+        LOOP_L_N(a, NUM_SHAPED_AXES) {
+          shaping[a].delta_error = 0;
+          shaping[a].last_block_end_pos = count_position[shaped_axis[a]];
+        }
       #endif
     }
   }
@@ -1694,9 +1723,30 @@ void Stepper::pulse_phase_isr() {
     #else
       #define HYSTERESIS_Y 0
     #endif
+    #if AXIS_DRIVER_TYPE_Z(TMC2208) || AXIS_DRIVER_TYPE_Z(TMC2208_STANDALONE) || \
+        AXIS_DRIVER_TYPE_Z(TMC5160) || AXIS_DRIVER_TYPE_Z(TMC5160_STANDALONE)
+      #define HYSTERESIS_Z 64
+    #else
+      #define HYSTERESIS_Z 0
+    #endif
+    #if AXIS_DRIVER_TYPE_E0(TMC2208) || AXIS_DRIVER_TYPE_E0(TMC2208_STANDALONE) || \
+        AXIS_DRIVER_TYPE_E0(TMC5160) || AXIS_DRIVER_TYPE_E0(TMC5160_STANDALONE)
+      #define HYSTERESIS_E 64
+    #else
+      #define HYSTERESIS_E 0
+    #endif
     #define _HYSTERESIS(AXIS) HYSTERESIS_##AXIS
     #define HYSTERESIS(AXIS) _HYSTERESIS(AXIS)
 
+    // Flip the direction of a shaped axis. E drives the stepper of the active extruder.
+    #define SET_SHAPED_DIR_X() SET_STEP_DIR(X)
+    #define SET_SHAPED_DIR_Y() SET_STEP_DIR(Y)
+    #define SET_SHAPED_DIR_Z() SET_STEP_DIR(Z)
+    #define SET_SHAPED_DIR_E() do{ \
+      if (motor_direction(E_AXIS)) { REV_E_DIR(stepper_extruder); count_direction.e = -1; } \
+      else { NORM_E_DIR(stepper_extruder); count_direction.e = 1; } \
+    }while(0)
+
     #define PULSE_PREP_SHAPING(AXIS, DELTA_ERROR, DIVIDEND) do{ \
       if (step_needed[_AXIS(AXIS)]) { \
         DELTA_ERROR += (DIVIDEND); \
@@ -1704,7 +1754,7 @@ void Stepper::pulse_phase_isr() {
           { USING_TIMED_PULSE(); START_TIMED_PULSE(); AWAIT_LOW_PULSE(); } \
           TBI(last_direction_bits, _AXIS(AXIS)); \
           DIR_WAIT_BEFORE(); \
-          SET_STEP_DIR(AXIS); \
+          SET_SHAPED_DIR_##AXIS(); \
           DIR_WAIT_AFTER(); \
         } \
         step_needed[_AXIS(AXIS)] = DELTA_ERROR <= -(64 + HYSTERESIS(AXIS)) || DELTA_ERROR >= (64 + HYSTERESIS(AXIS)); \
@@ -1879,20 +1929,26 @@ void Stepper::pulse_phase_isr() {
 
       #if HAS_SHAPING
         // record an echo if a step is needed in the primary bresenham
-        const bool x_step = TERN0(INPUT_SHAPING_X, shaping_x.enabled && step_needed[X_AXIS]),
-                   y_step = TERN0(INPUT_SHAPING_Y, shaping_y.enabled && step_needed[Y_AXIS]);
-        if (x_step || y_step)
-          ShapingQueue::enqueue(x_step, TERN0(INPUT_SHAPING_X, shaping_x.forward), y_step, TERN0(INPUT_SHAPING_Y, shaping_y.forward));
+        uint8_t echoes = 0;
+        #define _SHAPING_ECHO(A) do{ \
+          const ShapeParams &sp = shaping[SHAPED_##A]; \
+          if (sp.enabled && step_needed[_AXIS(A)]) echoes |= (sp.forward ? ECHO_FWD : ECHO_BWD) << (SHAPED_##A * 2); \
+        }while(0)
+        TERN_(INPUT_SHAPING_X, _SHAPING_ECHO(X));
+        TERN_(INPUT_SHAPING_Y, _SHAPING_ECHO(Y));
+        TERN_(INPUT_SHAPING_Z, _SHAPING_ECHO(Z));
+        TERN_(INPUT_SHAPING_E, _SHAPING_ECHO(E));
+        if (echoes) ShapingQueue::enqueue(echoes);
 
         // do the first part of the secondary bresenham
-        #if ENABLED(INPUT_SHAPING_X)
-          if (shaping_x.enabled)
-            PULSE_PREP_SHAPING(X, shaping_x.delta_error, shaping_x.factor1 * (shaping_x.forward ? 1 : -1));
-        #endif
-        #if ENABLED(INPUT_SHAPING_Y)
-          if (shaping_y.enabled)
-            PULSE_PREP_SHAPING(Y, shaping_y.delta_error, shaping_y.factor1 * (shaping_y.forward ? 1 : -1));
-        #endif
+        #define _SHAPING_PREP(A) do{ \
+          ShapeParams &sp = shaping[SHAPED_##A]; \
+          if (sp.enabled) PULSE_PREP_SHAPING(A, sp.delta_error, sp.factors[0] * (sp.forward ? 1 : -1)); \
+        }while(0)
+        TERN_(INPUT_SHAPING_X, _SHAPING_PREP(X));
+        TERN_(INPUT_SHAPING_Y, _SHAPING_PREP(Y));
+        TERN_(INPUT_SHAPING_Z, _SHAPING_PREP(Z));
+        TERN_(INPUT_SHAPING_E, _SHAPING_PREP(E));
       #endif
     }
 
@@ -1994,28 +2050,34 @@ void Stepper::pulse_phase_isr() {
 #if HAS_SHAPING
 
   void Stepper::shaping_isr() {
-    xy_bool_t step_needed{0};
+    xyze_bool_t step_needed{0};
+    int8_t echo[NUM_SHAPED_AXES];   // The echo stream to apply on each axis
 
     // Clear the echoes that are ready to process. If the buffers are too full and risk overflo, also apply echoes early.
-    TERN_(INPUT_SHAPING_X, step_needed[X_AXIS] = !ShapingQueue::peek_x() || ShapingQueue::free_count_x() < steps_per_isr);
-    TERN_(INPUT_SHAPING_Y, step_needed[Y_AXIS] = !ShapingQueue::peek_y() || ShapingQueue::free_count_y() < steps_per_isr);
+    // One echo per axis is applied per pass, so a single step is enough to follow it.
+    #define _SHAPING_DUE(A) step_needed[_AXIS(A)] = (echo[SHAPED_##A] = ShapingQueue::due(SHAPED_##A, steps_per_isr)) >= 0;
+    #define SHAPING_DUE() do{ \
+      TERN_(INPUT_SHAPING_X, _SHAPING_DUE(X)) TERN_(INPUT_SHAPING_Y, _SHAPING_DUE(Y)) \
+      TERN_(INPUT_SHAPING_Z, _SHAPING_DUE(Z)) TERN_(INPUT_SHAPING_E, _SHAPING_DUE(E)) \
+    }while(0)
 
-    if (bool(step_needed)) while (true) {
-      #if ENABLED(INPUT_SHAPING_X)
-        if (step_needed[X_AXIS]) {
-          const bool forward = ShapingQueue::dequeue_x();
-          PULSE_PREP_SHAPING(X, shaping_x.delta_error, shaping_x.factor2 * (forward ? 1 : -1));
-          PULSE_START(X);
-        }
-      #endif
+    #define _SHAPING_PULSE(A) do{ \
+      if (step_needed[_AXIS(A)]) { \
+        ShapeParams &sp = shaping[SHAPED_##A]; \
+        const int8_t e = echo[SHAPED_##A]; \
+        const bool forward = ShapingQueue::dequeue(SHAPED_##A, e); \
+        PULSE_PREP_SHAPING(A, sp.delta_error, sp.factors[e + 1] * (forward ? 1 : -1)); \
+        PULSE_START(A); \
+      } \
+    }while(0)
 
-      #if ENABLED(INPUT_SHAPING_Y)
-        if (step_needed[Y_AXIS]) {
-          const bool forward = ShapingQueue::dequeue_y();
-          PULSE_PREP_SHAPING(Y, shaping_y.delta_error, shaping_y.factor2 * (forward ? 1 : -1));
-          PULSE_START(Y);
-        }
-      #endif
+    SHAPING_DUE();
+
+    if (bool(step_needed)) while (true) {
+      TERN_(INPUT_SHAPING_X, _SHAPING_PULSE(X));
+      TERN_(INPUT_SHAPING_Y, _SHAPING_PULSE(Y));
+      TERN_(INPUT_SHAPING_Z, _SHAPING_PULSE(Z));
+      TERN_(INPUT_SHAPING_E, _SHAPING_PULSE(E));
 
       TERN_(I2S_STEPPER_STREAM, i2s_push_sample());
 
@@ -2025,16 +2087,13 @@ void Stepper::pulse_phase_isr() {
           START_TIMED_PULSE();
           AWAIT_HIGH_PULSE();
         #endif
-        #if ENABLED(INPUT_SHAPING_X)
-          PULSE_STOP(X);
-        #endif
-        #if ENABLED(INPUT_SHAPING_Y)
-          PULSE_STOP(Y);
-        #endif
+        TERN_(INPUT_SHAPING_X, PULSE_STOP(X));
+        TERN_(INPUT_SHAPING_Y, PULSE_STOP(Y));
+        TERN_(INPUT_SHAPING_Z, PULSE_STOP(Z));
+        TERN_(INPUT_SHAPING_E, PULSE_STOP(E));
       }
 
-      TERN_(INPUT_SHAPING_X, step_needed[X_AXIS] = !ShapingQueue::peek_x() || ShapingQueue::free_count_x() < steps_per_isr);
-      TERN_(INPUT_SHAPING_Y, step_needed[Y_AXIS] = !ShapingQueue::peek_y() || ShapingQueue::free_count_y() < steps_per_isr);
+      SHAPING_DUE();
 
       if (!bool(step_needed)) break;
 
@@ -2045,6 +2104,100 @@ void Stepper::pulse_phase_isr() {
 
 #endif // HAS_SHAPING
 
+#if ENABLED(FT_MOTION)
+
+  // Play back one tick from the fixed-time command buffer
+  uint32_t Stepper::ft_motion_isr() {
+    // Nothing to do, or a quick stop waiting for FTMotion::loop() to flush the buffer
+    if (abort_current_block) return (STEPPER_TIMER_RATE) / 1000;
+    if (!FTMotion::has_command()) {
+      FTMotion::underrun();
+      return (STEPPER_TIMER_RATE) / 1000;
+    }
+
+    const ft_command_t cmd = FTMotion::next_command();
+
+    const axis_bits_t dirs = axis_bits_t(cmd >> FTM_DIR_SHIFT);
+    if (dirs != last_direction_bits) set_directions(dirs);
+
+    xyze_bool_t step_needed{0};
+    LOOP_LOGICAL_AXES(i) step_needed[i] = TEST(cmd, i);
+
+    #if HAS_X_STEP
+      PULSE_START(X);
+    #endif
+    #if HAS_Y_STEP
+      PULSE_START(Y);
+    #endif
+    #if HAS_Z_STEP
+      PULSE_START(Z);
+    #endif
+    #if HAS_I_STEP
+      PULSE_START(I);
+    #endif
+    #if HAS_J_STEP
+      PULSE_START(J);
+    #endif
+    #if HAS_K_STEP
+      PULSE_START(K);
+    #endif
+    #if HAS_U_STEP
+      PULSE_START(U);
+    #endif
+    #if HAS_V_STEP
+      PULSE_START(V);
+    #endif
+    #if HAS_W_STEP
+      PULSE_START(W);
+    #endif
+    #if HAS_E0_STEP
+      PULSE_START(E);
+    #endif
+
+    TERN_(I2S_STEPPER_STREAM, i2s_push_sample());
+
+    #if ISR_MULTI_STEPS
+      USING_TIMED_PULSE();
+      START_TIMED_PULSE();
+      AWAIT_HIGH_PULSE();
+    #endif
+
+    #if HAS_X_STEP
+      PULSE_STOP(X);
+    #endif
+    #if HAS_Y_STEP
+      PULSE_STOP(Y);
+    #endif
+    #if HAS_Z_STEP
+      PULSE_STOP(Z);
+    #endif
+    #if HAS_I_STEP
+      PULSE_STOP(I);
+    #endif
+    #if HAS_J_STEP
+      PULSE_STOP(J);
+    #endif
+    #if HAS_K_STEP
+      PULSE_STOP(K);
+    #endif
+    #if HAS_U_STEP
+      PULSE_STOP(U);
+    #endif
+    #if HAS_V_STEP
+      PULSE_STOP(V);
+    #endif
+    #if HAS_W_STEP
+      PULSE_STOP(W);
+    #endif
+    #if HAS_E0_STEP
+      PULSE_STOP(E);
+    #endif
+
+    return FTM_ISR_INTERVAL;
+  }
+
+#endif // FT_MOTION
+
 // Calculate timer interval, with all limits applied.
 uint32_t Stepper::calc_timer_interval(uint32_t step_rate) {
   #ifdef CPU_32_BIT
@@ -2076,9 +2229,9 @@ uint32_t Stepper::calc_timer_interval(uint32_t step_rate) {
   #endif
 }
 
-// Get the timer interval and the number of loops to perform per tick
-uint32_t Stepper::calc_timer_interval(uint32_t step_rate, uint8_t &loops) {
-  uint8_t multistep = 1;
+// Get the steps per ISR for a step rate, as a power of 2
+uint8_t Stepper::calc_multistep_shift(uint32_t step_rate) {
+  uint8_t idx = 0;
   #if DISABLED(DISABLE_MULTI_STEPPING)
 
     // The stepping frequency limits for each multistepping rate
@@ -2094,20 +2247,56 @@ uint32_t Stepper::calc_timer_interval(uint32_t step_rate, uint8_t &loops) {
     };
 
     // Select the proper multistepping
-    uint8_t idx = 0;
     while (idx < 7 && step_rate > (uint32_t)pgm_read_dword(&limit[idx])) {
       step_rate >>= 1;
-      multistep <<= 1;
       ++idx;
     };
   #else
-    NOMORE(step_rate, uint32_t(MAX_STEP_ISR_FREQUENCY_1X));
+    UNUSED(step_rate);
   #endif
-  loops = multistep;
+  return idx;
+}
 
+// Get the timer interval and the number of loops to perform per tick
+uint32_t Stepper::calc_timer_interval(uint32_t step_rate, uint8_t &loops) {
+  const uint8_t shift = calc_multistep_shift(step_rate);
+  loops = _BV(shift);
+  step_rate >>= shift;
+  TERN_(DISABLE_MULTI_STEPPING, NOMORE(step_rate, uint32_t(MAX_STEP_ISR_FREQUENCY_1X)));
   return calc_timer_interval(step_rate);
 }
 
+#if HAS_RAMP_TABLE
+
+  /**
+   * Get the timer interval at 'time' into a speed ramp from the planner,
+   * setting the step rate and the steps per ISR. Once the ramp is done,
+   * or the line past its last piece reaches it, the rate is 'end_rate'.
+   */
+  uint32_t Stepper::calc_ramp_interval(const ramp_table_t &ramp, const uint32_t time, const uint32_t end_rate, uint32_t &step_rate) {
+    const uint32_t i = time >> ramp.piece_bits;
+    uint8_t shift;
+    if (i < ramp.pieces) {
+      // Interpolate the piece by a 24-bit fraction
+      const uint32_t r0 = ramp.rate[i], r1 = ramp.rate[i + 1],
+                     frac = (time & (_BV32(ramp.piece_bits) - 1)) << (24 - ramp.piece_bits);
+      step_rate = r1 > r0 ? _MIN(r0 + STEP_MULTIPLY(frac, r1 - r0), end_rate)
+                          : _MAX(r0 - STEP_MULTIPLY(frac, r0 - r1), end_rate);
+      shift = ramp.shift[i];
+    }
+    else {
+      step_rate = end_rate;
+      shift = ramp.shift[ramp.pieces];
+    }
+
+    steps_per_isr = _BV(shift);
+    uint32_t isr_rate = (step_rate << oversampling_factor) >> shift;
+    TERN_(DISABLE_MULTI_STEPPING, NOMORE(isr_rate, uint32_t(MAX_STEP_ISR_FREQUENCY_1X)));
+    return calc_timer_interval(isr_rate);
+  }
+
+#endif
+
 // This is the last half of the stepper interrupt: This one processes and
 // properly schedules blocks from the planner. This is executed after creating
 // the step pulses, so it is not time critical, as pulses are already done.
@@ -2147,20 +2336,26 @@ uint32_t Stepper::block_phase_isr() {
       // Are we in acceleration phase ?
       if (step_events_completed <= accelerate_until) { // Calculate new timer value
 
-        #if ENABLED(S_CURVE_ACCELERATION)
-          // Get the next speed to use (Jerk limited!)
-          uint32_t acc_step_rate = acceleration_time < current_block->acceleration_time
-                                   ? _eval_bezier_curve(acceleration_time)
-                                   : current_block->cruise_rate;
+        #if HAS_RAMP_TABLE
+          // Get the next speed, timer interval and steps per stepper isr from the planned ramp
+          uint32_t acc_step_rate;
+          interval = calc_ramp_interval(current_block->accel_ramp, acceleration_time, current_block->cruise_rate, acc_step_rate);
         #else
-          acc_step_rate = STEP_MULTIPLY(acceleration_time, current_block->acceleration_rate) + current_block->initial_rate;
-          NOMORE(acc_step_rate, current_block->nominal_rate);
-        #endif
+          #if ENABLED(S_CURVE_ACCELERATION)
+            // Get the next speed to use (Jerk limited!)
+            uint32_t acc_step_rate = acceleration_time < current_block->acceleration_time
+                                     ? _eval_bezier_curve(acceleration_time)
+                                     : current_block->cruise_rate;
+          #else
+            acc_step_rate = STEP_MULTIPLY(acceleration_time, current_block->acceleration_rate) + current_block->initial_rate;
+            NOMORE(acc_step_rate, current_block->nominal_rate);
+          #endif
 
-        // acc_step_rate is in steps/second
+          // acc_step_rate is in steps/second
 
-        // step_rate to timer interval and steps per stepper isr
-        interval = calc_timer_interval(acc_step_rate << oversampling_factor, steps_per_isr);
+          // step_rate to timer interval and steps per stepper isr
+          interval = calc_timer_interval(acc_step_rate << oversampling_factor, steps_per_isr);
+        #endif
         acceleration_time += interval;
 
         #if ENABLED(LIN_ADVANCE)
@@ -2200,37 +2395,42 @@ uint32_t Stepper::block_phase_isr() {
       else if (step_events_completed > decelerate_after) {
         uint32_t step_rate;
 
-        #if ENABLED(S_CURVE_ACCELERATION)
+        #if HAS_RAMP_TABLE
+          // Get the next speed, timer interval and steps per stepper isr from the planned ramp
+          interval = calc_ramp_interval(current_block->decel_ramp, deceleration_time, current_block->final_rate, step_rate);
+        #else
+          #if ENABLED(S_CURVE_ACCELERATION)
+
+            // If this is the 1st time we process the 2nd half of the trapezoid...
+            if (!bezier_2nd_half) {
+              // Initialize the Bézier speed curve
+              _calc_bezier_curve_coeffs(current_block->cruise_rate, current_block->final_rate, current_block->deceleration_time_inverse);
+              bezier_2nd_half = true;
+              // The first point starts at cruise rate. Just save evaluation of the Bézier curve
+              step_rate = current_block->cruise_rate;
+            }
+            else {
+              // Calculate the next speed to use
+              step_rate = deceleration_time < current_block->deceleration_time
+                ? _eval_bezier_curve(deceleration_time)
+                : current_block->final_rate;
+            }
 
-          // If this is the 1st time we process the 2nd half of the trapezoid...
-          if (!bezier_2nd_half) {
-            // Initialize the Bézier speed curve
-            _calc_bezier_curve_coeffs(current_block->cruise_rate, current_block->final_rate, current_block->deceleration_time_inverse);
-            bezier_2nd_half = true;
-            // The first point starts at cruise rate. Just save evaluation of the Bézier curve
-            step_rate = current_block->cruise_rate;
-          }
-          else {
-            // Calculate the next speed to use
-            step_rate = deceleration_time < current_block->deceleration_time
-              ? _eval_bezier_curve(deceleration_time)
-              : current_block->final_rate;
-          }
+          #else
+            // Using the old trapezoidal control
+            step_rate = STEP_MULTIPLY(deceleration_time, current_block->acceleration_rate);
+            if (step_rate < acc_step_rate) { // Still decelerating?
+              step_rate = acc_step_rate - step_rate;
+              NOLESS(step_rate, current_block->final_rate);
+            }
+            else
+              step_rate = current_block->final_rate;
 
-        #else
-          // Using the old trapezoidal control
-          step_rate = STEP_MULTIPLY(deceleration_time, current_block->acceleration_rate);
-          if (step_rate < acc_step_rate) { // Still decelerating?
-            step_rate = acc_step_rate - step_rate;
-            NOLESS(step_rate, current_block->final_rate);
-          }
-          else
-            step_rate = current_block->final_rate;
+          #endif
 
+          // step_rate to timer interval and steps per stepper isr
+          interval = calc_timer_interval(step_rate << oversampling_factor, steps_per_isr);
         #endif
-
-        // step_rate to timer interval and steps per stepper isr
-        interval = calc_timer_interval(step_rate << oversampling_factor, steps_per_isr);
         deceleration_time += interval;
 
         #if ENABLED(LIN_ADVANCE)
@@ -2494,14 +2694,8 @@ uint32_t Stepper::block_phase_isr() {
       acceleration_time = deceleration_time = 0;
 
       #if ENABLED(ADAPTIVE_STEP_SMOOTHING)
-        oversampling_factor = 0;                            // Assume no axis smoothing (via oversampling)
-        // Decide if axis smoothing is possible
-        uint32_t max_rate = current_block->nominal_rate;    // Get the step event rate
-        while (max_rate < MIN_STEP_ISR_FREQUENCY) {         // As long as more ISRs are possible...
-          max_rate <<= 1;                                   // Try to double the rate
-          if (max_rate < MIN_STEP_ISR_FREQUENCY)            // Don't exceed the estimated ISR limit
-            ++oversampling_factor;                          // Increase the oversampling (used for left-shift)
-        }
+        // Decide if axis smoothing is possible. The planner's ramp tables assume the same factor.
+        oversampling_factor = calc_oversampling(current_block->nominal_rate);
       #endif
 
       // Based on the oversampling factor, do the calculations
@@ -2514,26 +2708,19 @@ uint32_t Stepper::block_phase_isr() {
       advance_dividend = (current_block->steps << 1).asLong();
       advance_divisor = step_event_count << 1;
 
-      #if ENABLED(INPUT_SHAPING_X)
-        if (shaping_x.enabled) {
-          const int64_t steps = TEST(current_block->direction_bits, X_AXIS) ? -int64_t(current_block->steps.x) : int64_t(current_block->steps.x);
-          shaping_x.last_block_end_pos += steps;
+      #if HAS_SHAPING
+        LOOP_L_N(a, NUM_SHAPED_AXES) {
+          ShapeParams &sp = shaping[a];
+          if (!sp.enabled) continue;
+          const AxisEnum axis = shaped_axis[a];
+          const int64_t steps = TEST(current_block->direction_bits, axis) ? -int64_t(current_block->steps[axis]) : int64_t(current_block->steps[axis]);
+          sp.last_block_end_pos += steps;
 
           // If there are any remaining echos unprocessed, then direction change must
           // be delayed and processed in PULSE_PREP_SHAPING. This will cause half a step
-          // to be missed, which will need recovering and this can be done through shaping_x.remainder.
-          shaping_x.forward = !TEST(current_block->direction_bits, X_AXIS);
-          if (!ShapingQueue::empty_x()) SET_BIT_TO(current_block->direction_bits, X_AXIS, TEST(last_direction_bits, X_AXIS));
-        }
-      #endif
-
-      // Y follows the same logic as X (but the comments aren't repeated)
-      #if ENABLED(INPUT_SHAPING_Y)
-        if (shaping_y.enabled) {
-          const int64_t steps = TEST(current_block->direction_bits, Y_AXIS) ? -int64_t(current_block->steps.y) : int64_t(current_block->steps.y);
-          shaping_y.last_block_end_pos += steps;
-          shaping_y.forward = !TEST(current_block->direction_bits, Y_AXIS);
-          if (!ShapingQueue::empty_y()) SET_BIT_TO(current_block->direction_bits, Y_AXIS, TEST(last_direction_bits, Y_AXIS));
+          // to be missed, which will need recovering and this can be done through delta_error.
+          sp.forward = !TEST(current_block->direction_bits, axis);
+          if (!ShapingQueue::empty(a)) SET_BIT_TO(current_block->direction_bits, axis, TEST(last_direction_bits, axis));
         }
       #endif
 
@@ -2600,7 +2787,9 @@ uint32_t Stepper::block_phase_isr() {
       // Mark the time_nominal as not calculated yet
       ticks_nominal = -1;
 
-      #if ENABLED(S_CURVE_ACCELERATION)
+      #if HAS_RAMP_TABLE
+        // The planner has the speed ramps ready
+      #elif ENABLED(S_CURVE_ACCELERATION)
         // Initialize the Bézier speed curve
         _calc_bezier_curve_coeffs(current_block->initial_rate, current_block->cruise_rate, current_block->acceleration_time_inverse);
         // We haven't started the 2nd half of the trapezoid
@@ -3021,72 +3210,150 @@ void Stepper::init() {
 #if HAS_SHAPING
 
   /**
-   * Calculate a fixed point factor to apply to the signal and its echo
-   * when shaping an axis.
+   * Calculate the fixed point factors to apply to the signal and its echoes
+   * when shaping an axis. They add up to 128, one full step.
    */
-  void Stepper::set_shaping_damping_ratio(const AxisEnum axis, const_float_t zeta) {
-    // from the damping ratio, get a factor that can be applied to advance_dividend for fixed point maths
-    // for ZV, we use amplitudes 1/(1+K) and K/(1+K) where K = exp(-zeta * M_PI / sqrt(1.0f - zeta * zeta))
-    // which can be converted to 1:7 fixed point with an excellent fit with a 3rd order polynomial
-    float factor2;
-    if (zeta <= 0.0f) factor2 = 64.0f;
-    else if (zeta >= 1.0f) factor2 = 0.0f;
-    else {
-      factor2 = 64.44056192 + -99.02008832 * zeta;
-      const_float_t zeta2 = zeta * zeta;
-      factor2 += -7.58095488 * zeta2;
-      const_float_t zeta3 = zeta2 * zeta;
-      factor2 += 43.073216 * zeta3;
-      factor2 = floor(factor2);
+  static void calc_shaping_factors(ShapeParams &shaping) {
+    const float zeta = shaping.zeta;
+    uint8_t (&factors)[SHAPING_MAX_IMPULSES] = shaping.factors;
+
+    if (shaping.type == SHAPER_ZV) {
+      // from the damping ratio, get a factor that can be applied to advance_dividend for fixed point maths
+      // for ZV, we use amplitudes 1/(1+K) and K/(1+K) where K = exp(-zeta * M_PI / sqrt(1.0f - zeta * zeta))
+      // which can be converted to 1:7 fixed point with an excellent fit with a 3rd order polynomial
+      float factor2;
+      if (zeta <= 0.0f) factor2 = 64.0f;
+      else if (zeta >= 1.0f) factor2 = 0.0f;
+      else {
+        factor2 = 64.44056192 + -99.02008832 * zeta;
+        const_float_t zeta2 = zeta * zeta;
+        factor2 += -7.58095488 * zeta2;
+        const_float_t zeta3 = zeta2 * zeta;
+        factor2 += 43.073216 * zeta3;
+        factor2 = floor(factor2);
+      }
+      factors[0] = 128 - factor2;
+      factors[1] = factor2;
+      return;
+    }
+
+    // The other shapers use the amplitudes given by Singhose et al. with a
+    // 5% vibration tolerance for the EI shapers. K is the decay over 1/2 period.
+    const float df = zeta < 1.0f ? SQRT(1.0f - sq(zeta)) : 0.0f,
+                K = df ? expf(-zeta * float(M_PI) / df) : 0.0f;
+    float a[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+    switch (shaping.type) {
+      default: break;
+      case SHAPER_ZVD:
+        a[1] = 2.0f * K; a[2] = sq(K);
+        break;
+      case SHAPER_MZV: {
+        const float Km = df ? expf(-0.75f * zeta * float(M_PI) / df) : 0.0f;
+        a[0] = 1.0f - float(M_SQRT1_2); a[1] = (float(M_SQRT2) - 1.0f) * Km; a[2] = a[0] * sq(Km);
+      } break;
+      case SHAPER_EI:
+        a[0] = 0.25f * 1.05f; a[1] = 0.5f * 0.95f * K; a[2] = a[0] * sq(K);
+        break;
+      case SHAPER_2HEI:
+        a[0] = 0.1597972f;  // (3X^2 + 2X + 3V^2) / 16X with X = cbrt(V^2 (sqrt(1 - V^2) + 1)), V = 0.05
+        a[1] = (0.5f - a[0]) * K; a[2] = a[1] * K; a[3] = a[0] * K * K * K;
+        break;
+    }
+
+    const uint8_t n = _MIN(shaper_impulses(shaping.type), SHAPING_MAX_IMPULSES);
+    float total = 0;
+    LOOP_L_N(i, n) total += a[i];
+    uint8_t rest = 0;
+    for (uint8_t i = 1; i < n; ++i) rest += (factors[i] = LROUND(128.0f * a[i] / total));
+    factors[0] = 128 - rest;
+  }
+
+  // Set up the echo streams of the queue for the axis shaper type and frequency
+  static void calc_shaping_delays(const uint8_t a, const ShapeParams &shaping) {
+    // When each echo comes, in 1/8 periods
+    static constexpr uint8_t echo_times[NUM_SHAPERS][3] = {
+      { 4 },          // ZV
+      { 4, 8 },       // EI
+      { 4, 8, 12 },   // 2HEI
+      { 4, 8 },       // ZVD
+      { 3, 6 }        // MZV
+    };
+    const uint8_t streams = shaper_impulses(shaping.type) - 1;
+    shaping_time_t delays[SHAPING_ECHO_STREAMS];
+    LOOP_L_N(s, streams) {
+      // Clamp long delays that don't fit AVR timing. M593 rejects them.
+      const float d = shaping.frequency ? float(uint32_t(STEPPER_TIMER_RATE) / 8) * echo_times[shaping.type][s] / shaping.frequency : float(shaping_time_t(-1));
+      delays[s] = d < float(shaping_time_t(-2)) ? shaping_time_t(d) : shaping_time_t(-2);
     }
+    ShapingQueue::set_delays(a, streams, delays);
+    ShapingQueue::purge();
+  }
 
+  void Stepper::set_shaping_damping_ratio(const AxisEnum axis, const_float_t zeta) {
+    const int8_t a = shaped_index(axis);
+    if (a < 0) return;
     const bool was_on = hal.isr_state();
     hal.isr_off();
-    TERN_(INPUT_SHAPING_X, if (axis == X_AXIS) { shaping_x.factor2 = factor2; shaping_x.factor1 = 128 - factor2; shaping_x.zeta = zeta; })
-    TERN_(INPUT_SHAPING_Y, if (axis == Y_AXIS) { shaping_y.factor2 = factor2; shaping_y.factor1 = 128 - factor2; shaping_y.zeta = zeta; })
+    shaping[a].zeta = zeta;
+    calc_shaping_factors(shaping[a]);
     if (was_on) hal.isr_on();
   }
 
   float Stepper::get_shaping_damping_ratio(const AxisEnum axis) {
-    TERN_(INPUT_SHAPING_X, if (axis == X_AXIS) return shaping_x.zeta);
-    TERN_(INPUT_SHAPING_Y, if (axis == Y_AXIS) return shaping_y.zeta);
-    return -1;
+    const int8_t a = shaped_index(axis);
+    return a < 0 ? -1 : shaping[a].zeta;
   }
 
   void Stepper::set_shaping_frequency(const AxisEnum axis, const_float_t freq) {
+    const int8_t a = shaped_index(axis);
+    if (a < 0) return;
+
     // enabling or disabling shaping whilst moving can result in lost steps
     planner.synchronize();
 
     const bool was_on = hal.isr_state();
     hal.isr_off();
 
-    const shaping_time_t delay = freq ? float(uint32_t(STEPPER_TIMER_RATE) / 2) / freq : shaping_time_t(-1);
-    #if ENABLED(INPUT_SHAPING_X)
-      if (axis == X_AXIS) {
-        ShapingQueue::set_delay(X_AXIS, delay);
-        shaping_x.frequency = freq;
-        shaping_x.enabled = !!freq;
-        shaping_x.delta_error = 0;
-        shaping_x.last_block_end_pos = count_position.x;
-      }
-    #endif
-    #if ENABLED(INPUT_SHAPING_Y)
-      if (axis == Y_AXIS) {
-        ShapingQueue::set_delay(Y_AXIS, delay);
-        shaping_y.frequency = freq;
-        shaping_y.enabled = !!freq;
-        shaping_y.delta_error = 0;
-        shaping_y.last_block_end_pos = count_position.y;
-      }
-    #endif
+    ShapeParams &sp = shaping[a];
+    sp.frequency = freq;
+    sp.enabled = !!freq;
+    sp.delta_error = 0;
+    sp.last_block_end_pos = count_position[axis];
+    calc_shaping_delays(a, sp);
 
     if (was_on) hal.isr_on();
   }
 
   float Stepper::get_shaping_frequency(const AxisEnum axis) {
-    TERN_(INPUT_SHAPING_X, if (axis == X_AXIS) return shaping_x.frequency);
-    TERN_(INPUT_SHAPING_Y, if (axis == Y_AXIS) return shaping_y.frequency);
-    return -1;
+    const int8_t a = shaped_index(axis);
+    return a < 0 ? -1 : shaping[a].frequency;
+  }
+
+  void Stepper::set_shaping_type(const AxisEnum axis, const ShaperType type) {
+    const int8_t a = shaped_index(axis);
+    if (a < 0) return;
+
+    // Types with more impulses than the step buffer was sized for are ignored
+    if (type >= NUM_SHAPERS || shaper_impulses(type) > SHAPING_MAX_IMPULSES) return;
+
+    // the echo streams change, so let the current ones play out
+    planner.synchronize();
+
+    const bool was_on = hal.isr_state();
+    hal.isr_off();
+
+    ShapeParams &sp = shaping[a];
+    sp.type = type;
+    sp.delta_error = 0;
+    calc_shaping_factors(sp);
+    calc_shaping_delays(a, sp);
+
+    if (was_on) hal.isr_on();
+  }
+
+  ShaperType Stepper::get_shaping_type(const AxisEnum axis) {
+    const int8_t a = shaped_index(axis);
+    return a < 0 ? SHAPER_ZV : shaping[a].type;
   }
 
 #endif // HAS_SHAPING
@@ -3101,11 +3368,14 @@ void Stepper::init() {
  * derive the current XYZE position later on.
  */
 void Stepper::_set_position(const abce_long_t &spos) {
-  #if ENABLED(INPUT_SHAPING_X)
-    const int32_t x_shaping_delta = count_position.x - shaping_x.last_block_end_pos;
+  #if BOTH(HAS_BAFSD, BAFSD_ODOMETER)
+    bafsd.e_position_set(count_position.e, spos.e);
   #endif
-  #if ENABLED(INPUT_SHAPING_Y)
-    const int32_t y_shaping_delta = count_position.y - shaping_y.last_block_end_pos;
+
+  #if HAS_SHAPING
+    // Steps still owed by the echoes of each shaped axis
+    int32_t shaping_delta[NUM_SHAPED_AXES];
+    LOOP_L_N(a, NUM_SHAPED_AXES) shaping_delta[a] = count_position[shaped_axis[a]] - shaping[a].last_block_end_pos;
   #endif
 
   #if ANY(IS_CORE, MARKFORGED_XY, MARKFORGED_YX)
@@ -3138,16 +3408,11 @@ void Stepper::_set_position(const abce_long_t &spos) {
     count_position = spos;
   #endif
 
-  #if ENABLED(INPUT_SHAPING_X)
-    if (shaping_x.enabled) {
-      count_position.x += x_shaping_delta;
-      shaping_x.last_block_end_pos = spos.x;
-    }
-  #endif
-  #if ENABLED(INPUT_SHAPING_Y)
-    if (shaping_y.enabled) {
-      count_position.y += y_shaping_delta;
-      shaping_y.last_block_end_pos = spos.y;
+  #if HAS_SHAPING
+    LOOP_L_N(a, NUM_SHAPED_AXES) if (shaping[a].enabled) {
+      const AxisEnum axis = shaped_axis[a];
+      count_position[axis] += shaping_delta[a];
+      shaping[a].last_block_end_pos = spos[axis];
     }
   #endif
 }
@@ -3188,9 +3453,14 @@ void Stepper::set_axis_position(const AxisEnum a, const int32_t &v) {
     const bool was_enabled = suspend();
   #endif
 
+  #if BOTH(HAS_BAFSD, BAFSD_ODOMETER)
+    if (a == E_AXIS) bafsd.e_position_set(count_position.e, v);
+  #endif
   count_position[a] = v;
-  TERN_(INPUT_SHAPING_X, if (a == X_AXIS) shaping_x.last_block_end_pos = v);
-  TERN_(INPUT_SHAPING_Y, if (a == Y_AXIS) shaping_y.last_block_end_pos = v);
+  #if HAS_SHAPING
+    const int8_t sa = shaped_index(a);
+    if (sa >= 0) shaping[sa].last_block_end_pos = v;
+  #endif
 
   #ifdef __AVR__
     // Reenable Stepper ISR
@@ -220,7 +220,8 @@
 #define ISR_LOOP_CYCLES(R) ((ISR_LOOP_BASE_CYCLES + MIN_ISR_LOOP_CYCLES + MIN_STEPPER_PULSE_CYCLES) * (R - 1) + _MAX(MIN_ISR_LOOP_CYCLES, MIN_STEPPER_PULSE_CYCLES))
 
 // Model input shaping as an extra loop call
-#define ISR_SHAPING_LOOP_CYCLES(R) TERN0(HAS_SHAPING, (R) * ((ISR_LOOP_BASE_CYCLES) + TERN0(INPUT_SHAPING_X, ISR_X_STEPPER_CYCLES) + TERN0(INPUT_SHAPING_Y, ISR_Y_STEPPER_CYCLES)))
+#define ISR_SHAPING_LOOP_CYCLES(R) TERN0(HAS_SHAPING, (R) * ((ISR_LOOP_BASE_CYCLES) + TERN0(INPUT_SHAPING_X, ISR_X_STEPPER_CYCLES) + TERN0(INPUT_SHAPING_Y, ISR_Y_STEPPER_CYCLES) \
+                                                                                  + TERN0(INPUT_SHAPING_Z, ISR_Z_STEPPER_CYCLES) + TERN0(INPUT_SHAPING_E, ISR_E_STEPPER_CYCLES)))
 
 // If linear advance is enabled, then it is handled separately
 #if ENABLED(LIN_ADVANCE)
@@ -337,7 +338,9 @@ constexpr ena_mask_t enable_overlap[] = {
     constexpr float     _ISDASU[] = DEFAULT_AXIS_STEPS_PER_UNIT;
     constexpr feedRate_t _ISDMF[] = DEFAULT_MAX_FEEDRATE;
     constexpr float max_shaped_rate = TERN0(INPUT_SHAPING_X, _ISDMF[X_AXIS] * _ISDASU[X_AXIS]) +
-                                      TERN0(INPUT_SHAPING_Y, _ISDMF[Y_AXIS] * _ISDASU[Y_AXIS]);
+                                      TERN0(INPUT_SHAPING_Y, _ISDMF[Y_AXIS] * _ISDASU[Y_AXIS]) +
+                                      TERN0(INPUT_SHAPING_Z, _ISDMF[Z_AXIS] * _ISDASU[Z_AXIS]) +
+                                      TERN0(INPUT_SHAPING_E, _ISDMF[E_AXIS] * _ISDASU[E_AXIS]);
     #if defined(__AVR__) || !defined(ADAPTIVE_STEP_SMOOTHING)
       // MIN_STEP_ISR_FREQUENCY is known at compile time on AVRs and any reduction in SRAM is welcome
       template<int INDEX=DISTINCT_AXES> constexpr float max_isr_rate() {
@@ -353,106 +356,129 @@ constexpr ena_mask_t enable_overlap[] = {
   #endif
 
   #ifndef SHAPING_MIN_FREQ
-    #define SHAPING_MIN_FREQ _MIN(0x7FFFFFFFL OPTARG(INPUT_SHAPING_X, SHAPING_FREQ_X) OPTARG(INPUT_SHAPING_Y, SHAPING_FREQ_Y))
+    #define SHAPING_MIN_FREQ _MIN(0x7FFFFFFFL OPTARG(INPUT_SHAPING_X, SHAPING_FREQ_X) OPTARG(INPUT_SHAPING_Y, SHAPING_FREQ_Y) \
+                                              OPTARG(INPUT_SHAPING_Z, SHAPING_FREQ_Z) OPTARG(INPUT_SHAPING_E, SHAPING_FREQ_E))
   #endif
+
+  // Each impulse after the first is an echo stream replaying the steps after its own delay
+  #define SHAPING_ECHO_STREAMS ((SHAPING_MAX_IMPULSES) - 1)
+
+  // The last echo comes 1/2 period after the step for each stream the shaper may use
   constexpr uint16_t shaping_min_freq = SHAPING_MIN_FREQ,
-                     shaping_echoes = max_step_rate / shaping_min_freq / 2 + 3;
+                     shaping_echoes = max_step_rate * (SHAPING_ECHO_STREAMS) / shaping_min_freq / 2 + 3;
 
   typedef IF<ENABLED(__AVR__), uint16_t, uint32_t>::type shaping_time_t;
-  enum shaping_echo_t { ECHO_NONE = 0, ECHO_FWD = 1, ECHO_BWD = 2 };
-  struct shaping_echo_axis_t {
-    TERN_(INPUT_SHAPING_X, shaping_echo_t x:2);
-    TERN_(INPUT_SHAPING_Y, shaping_echo_t y:2);
+  enum shaping_echo_t : uint8_t { ECHO_NONE = 0, ECHO_FWD = 1, ECHO_BWD = 2 };
+
+  // The shaped axes, in the order of the per-axis shaping arrays
+  enum ShapedAxis : uint8_t {
+    OPTITEM(INPUT_SHAPING_X, SHAPED_X)
+    OPTITEM(INPUT_SHAPING_Y, SHAPED_Y)
+    OPTITEM(INPUT_SHAPING_Z, SHAPED_Z)
+    OPTITEM(INPUT_SHAPING_E, SHAPED_E)
+    NUM_SHAPED_AXES
+  };
+  constexpr AxisEnum shaped_axis[NUM_SHAPED_AXES] = {
+    OPTITEM(INPUT_SHAPING_X, X_AXIS)
+    OPTITEM(INPUT_SHAPING_Y, Y_AXIS)
+    OPTITEM(INPUT_SHAPING_Z, Z_AXIS)
+    OPTITEM(INPUT_SHAPING_E, E_AXIS)
   };
+  // Index of an axis in the shaping arrays, -1 if it isn't shaped
+  constexpr int8_t shaped_index(const AxisEnum axis, const uint8_t a=0) {
+    return a == NUM_SHAPED_AXES ? -1 : shaped_axis[a] == axis ? a : shaped_index(axis, a + 1);
+  }
+
+  // Each queue entry holds a 2-bit shaping_echo_t per shaped axis
+  #define SHAPING_ECHO(E,A) shaping_echo_t(((E) >> ((A) * 2)) & 3)
+
+  // Shaper types, numbered as for M593 T
+  enum ShaperType : uint8_t { SHAPER_ZV, SHAPER_EI, SHAPER_2HEI, SHAPER_ZVD, SHAPER_MZV, NUM_SHAPERS };
+  #define _SHAPER_TYPE(T) SHAPER_##T
+  #define SHAPER_TYPE(T) _SHAPER_TYPE(T)
+
+  // Impulses of a shaper, and when its last one comes in 1/8 periods
+  constexpr uint8_t shaper_impulses(const ShaperType t) { return t == SHAPER_ZV ? 2 : t == SHAPER_2HEI ? 4 : 3; }
+  constexpr uint8_t shaper_span(const ShaperType t) { return t == SHAPER_ZV ? 4 : t == SHAPER_MZV ? 6 : t == SHAPER_2HEI ? 12 : 8; }
 
   class ShapingQueue {
     private:
-      static shaping_time_t       now;
-      static shaping_time_t       times[shaping_echoes];
-      static shaping_echo_axis_t  echo_axes[shaping_echoes];
-      static uint16_t             tail;
-
-      #if ENABLED(INPUT_SHAPING_X)
-        static shaping_time_t delay_x;    // = shaping_time_t(-1) to disable queueing
-        static shaping_time_t peek_x_val;
-        static uint16_t head_x;
-        static uint16_t _free_count_x;
-      #endif
-      #if ENABLED(INPUT_SHAPING_Y)
-        static shaping_time_t delay_y;    // = shaping_time_t(-1) to disable queueing
-        static shaping_time_t peek_y_val;
-        static uint16_t head_y;
-        static uint16_t _free_count_y;
-      #endif
+      static shaping_time_t now;
+      static shaping_time_t times[shaping_echoes];
+      static uint8_t        echo_axes[shaping_echoes];
+      static uint16_t       tail;
+
+      static uint8_t        streams[NUM_SHAPED_AXES];                           // Echo streams used by each axis' shaper
+      static shaping_time_t delay[NUM_SHAPED_AXES][SHAPING_ECHO_STREAMS];       // = shaping_time_t(-1) to disable queueing
+      static shaping_time_t peek_val[NUM_SHAPED_AXES][SHAPING_ECHO_STREAMS];
+      static uint16_t       head[NUM_SHAPED_AXES][SHAPING_ECHO_STREAMS];
+      static uint16_t       _free_count[NUM_SHAPED_AXES][SHAPING_ECHO_STREAMS];
 
     public:
       static void decrement_delays(const shaping_time_t interval) {
         now += interval;
-        TERN_(INPUT_SHAPING_X, if (peek_x_val != shaping_time_t(-1)) peek_x_val -= interval);
-        TERN_(INPUT_SHAPING_Y, if (peek_y_val != shaping_time_t(-1)) peek_y_val -= interval);
+        LOOP_L_N(a, NUM_SHAPED_AXES) LOOP_L_N(s, streams[a])
+          if (peek_val[a][s] != shaping_time_t(-1)) peek_val[a][s] -= interval;
       }
-      static void set_delay(const AxisEnum axis, const shaping_time_t delay) {
-        TERN_(INPUT_SHAPING_X, if (axis == X_AXIS) delay_x = delay);
-        TERN_(INPUT_SHAPING_Y, if (axis == Y_AXIS) delay_y = delay);
+      // Set the delay of each echo stream of a shaped axis. Call with the queue empty.
+      static void set_delays(const uint8_t a, const uint8_t n, const shaping_time_t delays[]) {
+        streams[a] = n;
+        LOOP_L_N(s, n) delay[a][s] = delays[s];
       }
-      static void enqueue(const bool x_step, const bool x_forward, const bool y_step, const bool y_forward) {
-        TERN_(INPUT_SHAPING_X, if (head_x == tail && x_step) peek_x_val = delay_x);
-        TERN_(INPUT_SHAPING_Y, if (head_y == tail && y_step) peek_y_val = delay_y);
+      // Queue a step event. echoes holds a shaping_echo_t per shaped axis.
+      static void enqueue(const uint8_t echoes) {
+        LOOP_L_N(a, NUM_SHAPED_AXES) if (SHAPING_ECHO(echoes, a))
+          LOOP_L_N(s, streams[a]) if (head[a][s] == tail) peek_val[a][s] = delay[a][s];
         times[tail] = now;
-        TERN_(INPUT_SHAPING_X, echo_axes[tail].x = x_step ? (x_forward ? ECHO_FWD : ECHO_BWD) : ECHO_NONE);
-        TERN_(INPUT_SHAPING_Y, echo_axes[tail].y = y_step ? (y_forward ? ECHO_FWD : ECHO_BWD) : ECHO_NONE);
+        echo_axes[tail] = echoes;
         if (++tail == shaping_echoes) tail = 0;
-        TERN_(INPUT_SHAPING_X, _free_count_x--);
-        TERN_(INPUT_SHAPING_Y, _free_count_y--);
-        TERN_(INPUT_SHAPING_X, if (echo_axes[head_x].x == ECHO_NONE) dequeue_x());
-        TERN_(INPUT_SHAPING_Y, if (echo_axes[head_y].y == ECHO_NONE) dequeue_y());
-      }
-      #if ENABLED(INPUT_SHAPING_X)
-        static shaping_time_t peek_x() { return peek_x_val; }
-        static bool dequeue_x() {
-          bool forward = echo_axes[head_x].x == ECHO_FWD;
-          do {
-            _free_count_x++;
-            if (++head_x == shaping_echoes) head_x = 0;
-          } while (head_x != tail && echo_axes[head_x].x == ECHO_NONE);
-          peek_x_val = head_x == tail ? shaping_time_t(-1) : times[head_x] + delay_x - now;
-          return forward;
+        LOOP_L_N(a, NUM_SHAPED_AXES) LOOP_L_N(s, streams[a]) {
+          _free_count[a][s]--;
+          if (!SHAPING_ECHO(echo_axes[head[a][s]], a)) dequeue(a, s);
         }
-        static bool empty_x() { return head_x == tail; }
-        static uint16_t free_count_x() { return _free_count_x; }
-      #endif
-      #if ENABLED(INPUT_SHAPING_Y)
-        static shaping_time_t peek_y() { return peek_y_val; }
-        static bool dequeue_y() {
-          bool forward = echo_axes[head_y].y == ECHO_FWD;
-          do {
-            _free_count_y++;
-            if (++head_y == shaping_echoes) head_y = 0;
-          } while (head_y != tail && echo_axes[head_y].y == ECHO_NONE);
-          peek_y_val = head_y == tail ? shaping_time_t(-1) : times[head_y] + delay_y - now;
-          return forward;
-        }
-        static bool empty_y() { return head_y == tail; }
-        static uint16_t free_count_y() { return _free_count_y; }
-      #endif
+      }
+      // Time until the next echo of any axis and stream
+      static shaping_time_t peek() {
+        shaping_time_t t = shaping_time_t(-1);
+        LOOP_L_N(a, NUM_SHAPED_AXES) LOOP_L_N(s, streams[a]) NOMORE(t, peek_val[a][s]);
+        return t;
+      }
+      // The first echo stream of an axis that is due, or about to overflow. -1 for none.
+      static int8_t due(const uint8_t a, const uint16_t min_free) {
+        LOOP_L_N(s, streams[a]) if (!peek_val[a][s] || _free_count[a][s] < min_free) return s;
+        return -1;
+      }
+      static bool dequeue(const uint8_t a, const uint8_t s) {
+        const bool forward = SHAPING_ECHO(echo_axes[head[a][s]], a) == ECHO_FWD;
+        do {
+          _free_count[a][s]++;
+          if (++head[a][s] == shaping_echoes) head[a][s] = 0;
+        } while (head[a][s] != tail && !SHAPING_ECHO(echo_axes[head[a][s]], a));
+        peek_val[a][s] = head[a][s] == tail ? shaping_time_t(-1) : times[head[a][s]] + delay[a][s] - now;
+        return forward;
+      }
+      static bool empty(const uint8_t a) {
+        LOOP_L_N(s, streams[a]) if (head[a][s] != tail) return false;
+        return true;
+      }
+      static bool empty() {
+        LOOP_L_N(a, NUM_SHAPED_AXES) if (!empty(a)) return false;
+        return true;
+      }
       static void purge() {
-        const auto st = shaping_time_t(-1);
-        #if ENABLED(INPUT_SHAPING_X)
-          head_x = tail; _free_count_x = shaping_echoes - 1; peek_x_val = st;
-        #endif
-        #if ENABLED(INPUT_SHAPING_Y)
-          head_y = tail; _free_count_y = shaping_echoes - 1; peek_y_val = st;
-        #endif
+        LOOP_L_N(a, NUM_SHAPED_AXES) LOOP_L_N(s, SHAPING_ECHO_STREAMS) {
+          head[a][s] = tail; _free_count[a][s] = shaping_echoes - 1; peek_val[a][s] = shaping_time_t(-1);
+        }
       }
   };
 
   struct ShapeParams {
     float frequency;
     float zeta;
+    ShaperType type;
     bool enabled;
     int16_t delta_error = 0;    // delta_error for seconday bresenham mod 128
-    uint8_t factor1;
-    uint8_t factor2;
+    uint8_t factors[SHAPING_MAX_IMPULSES]; // 1:7 fixed point amplitude of the step and of each echo
     bool forward;
     int32_t last_block_end_pos = 0;
   };
@@ -465,6 +491,7 @@ constexpr ena_mask_t enable_overlap[] = {
 class Stepper {
   friend class KinematicSystem;
   friend class DeltaKinematicSystem;
+  friend class FTMotion;
   friend void stepperTask(void *);
 
   public:
@@ -551,7 +578,7 @@ class Stepper {
       static constexpr uint8_t stepper_extruder = 0;
     #endif
 
-    #if ENABLED(S_CURVE_ACCELERATION)
+    #if ENABLED(S_CURVE_ACCELERATION) && !HAS_RAMP_TABLE
       static int32_t bezier_A,     // A coefficient in Bézier speed curve
                      bezier_B,     // B coefficient in Bézier speed curve
                      bezier_C;     // C coefficient in Bézier speed curve
@@ -564,12 +591,7 @@ class Stepper {
     #endif
 
     #if HAS_SHAPING
-      #if ENABLED(INPUT_SHAPING_X)
-        static ShapeParams shaping_x;
-      #endif
-      #if ENABLED(INPUT_SHAPING_Y)
-        static ShapeParams shaping_y;
-      #endif
+      static ShapeParams shaping[NUM_SHAPED_AXES];
     #endif
 
     #if ENABLED(LIN_ADVANCE)
@@ -631,10 +653,30 @@ class Stepper {
     // The stepper block processing ISR phase
     static uint32_t block_phase_isr();
 
+    // Steps per ISR needed for a step rate, as a power of 2
+    static uint8_t calc_multistep_shift(uint32_t step_rate);
+
+    #if ENABLED(ADAPTIVE_STEP_SMOOTHING)
+      // Oversampling factor for a block's nominal rate, as many doublings as stay under the ISR limit
+      static uint8_t calc_oversampling(uint32_t max_rate) {
+        uint8_t factor = 0;
+        while (max_rate < MIN_STEP_ISR_FREQUENCY) {
+          max_rate <<= 1;
+          if (max_rate < MIN_STEP_ISR_FREQUENCY) ++factor;
+        }
+        return factor;
+      }
+    #endif
+
     #if HAS_SHAPING
       static void shaping_isr();
     #endif
 
+    #if ENABLED(FT_MOTION)
+      // The fixed-time motion playback ISR phase
+      static uint32_t ft_motion_isr();
+    #endif
+
     #if ENABLED(LIN_ADVANCE)
       // The Linear advance ISR phase
       static void advance_isr();
@@ -654,13 +696,27 @@ class Stepper {
     // Check if the given block is busy or not - Must not be called from ISR contexts
     static bool is_block_busy(const block_t * const block);
 
+    #if ENABLED(MPC_FLOW_FEEDFORWARD)
+      // The share of the block being stepped that is still to go, 1 if not known
+      static float block_left() {
+        const bool was_on = hal.isr_state();
+        hal.isr_off();
+
+        const float left = (current_block && step_event_count) ? float(step_event_count - step_events_completed) / step_event_count : 1.0f;
+
+        if (was_on) hal.isr_on();
+
+        return left;
+      }
+    #endif
+
     #if HAS_SHAPING
       // Check whether the stepper is processing any input shaping echoes
       static bool input_shaping_busy() {
         const bool was_on = hal.isr_state();
         hal.isr_off();
 
-        const bool result = TERN0(INPUT_SHAPING_X, !ShapingQueue::empty_x()) || TERN0(INPUT_SHAPING_Y, !ShapingQueue::empty_y());
+        const bool result = !ShapingQueue::empty();
 
         if (was_on) hal.isr_on();
 
@@ -807,6 +863,8 @@ class Stepper {
       static float get_shaping_damping_ratio(const AxisEnum axis);
       static void set_shaping_frequency(const AxisEnum axis, const_float_t freq);
       static float get_shaping_frequency(const AxisEnum axis);
+      static void set_shaping_type(const AxisEnum axis, const ShaperType type);
+      static ShaperType get_shaping_type(const AxisEnum axis);
     #endif
 
   private:
@@ -818,7 +876,9 @@ class Stepper {
     static uint32_t calc_timer_interval(uint32_t step_rate);
     static uint32_t calc_timer_interval(uint32_t step_rate, uint8_t &loops);
 
-    #if ENABLED(S_CURVE_ACCELERATION)
+    #if HAS_RAMP_TABLE
+      static uint32_t calc_ramp_interval(const ramp_table_t &ramp, const uint32_t time, const uint32_t end_rate, uint32_t &step_rate);
+    #elif ENABLED(S_CURVE_ACCELERATION)
       static void _calc_bezier_curve_coeffs(const int32_t v0, const int32_t v1, const uint32_t av);
       static int32_t _eval_bezier_curve(const uint32_t curr_step);
     #endif
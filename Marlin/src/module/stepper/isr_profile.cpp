@@ -0,0 +1,95 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2023 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(STEPPER_ISR_PROFILE)
+
+#include "isr_profile.h"
+#include "../stepper.h"
+
+ISRProfile isr_profile;
+
+isr_stat_t ISRProfile::stats[PHASES];
+uint32_t ISRProfile::overruns;
+millis_t ISRProfile::since_ms;
+
+AutoReporter<ISRProfile::AutoReportISR> ISRProfile::auto_reporter;
+
+void ISRProfile::reset() {
+  const bool was_on = stepper.suspend();
+  ZERO(stats);
+  overruns = 0;
+  since_ms = millis();
+  if (was_on) stepper.wake_up();
+}
+
+static FSTR_P phase_name(const uint8_t p) {
+  switch (p) {
+    #if ENABLED(FT_MOTION)
+      case ISRProfile::PH_FT_MOTION: return F("FTMotion");
+    #endif
+    #if HAS_SHAPING
+      case ISRProfile::PH_SHAPING:   return F("Shaping");
+    #endif
+    case ISRProfile::PH_PULSE:       return F("Pulse");
+    #if ENABLED(LIN_ADVANCE)
+      case ISRProfile::PH_ADVANCE:   return F("Advance");
+    #endif
+    #if ENABLED(INTEGRATED_BABYSTEPPING)
+      case ISRProfile::PH_BABYSTEP:  return F("Babystep");
+    #endif
+    case ISRProfile::PH_BLOCK:       return F("Block");
+    default:                         return F("ISR");
+  }
+}
+
+/**
+ * Times in ISR_PROFILE_UNIT. The load is the share of time spent in the
+ * ISR since the last reset. The short report has no per-phase lines.
+ */
+void ISRProfile::report(const bool full/*=true*/) {
+  if (!isr_profile_available()) {
+    SERIAL_ECHOLNPGM("Stepper ISR profile unavailable: no DWT cycle counter");
+    return;
+  }
+
+  // Copy the stats so the ISR can't change them while printing
+  const bool was_on = stepper.suspend();
+  isr_stat_t s[PHASES];
+  COPY(s, stats);
+  const uint32_t ovr = overruns;
+  if (was_on) stepper.wake_up();
+
+  const millis_t elapsed = millis() - since_ms;
+  const float load = elapsed ? s[PH_ISR].total * 100.0f / (float(elapsed) * (ISR_PROFILE_PER_MS)) : 0;
+  SERIAL_ECHOLNPGM("Stepper ISR load:", load, "% overruns:", ovr, " unit:" ISR_PROFILE_UNIT);
+
+  LOOP_L_N(p, PHASES) {
+    if (!full && p != PH_ISR) continue;
+    SERIAL_ECHOPGM("  ");
+    SERIAL_ECHOF(phase_name(p));
+    SERIAL_ECHOLNPGM(" n:", s[p].count, " avg:", s[p].avg(), " min:", s[p].min, " max:", s[p].max);
+  }
+}
+
+#endif // STEPPER_ISR_PROFILE
@@ -0,0 +1,97 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2023 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * isr_profile.h - Time spent in each phase of the stepper ISR
+ */
+
+#include "../../inc/MarlinConfig.h"
+#include "../../libs/autoreport.h"
+
+#ifdef __PLAT_LINUX__
+  #include <time.h>
+
+  // The host clock in ns, since the simulated ISR has no cycle count of its own
+  #define ISR_PROFILE_UNIT   "ns"
+  #define ISR_PROFILE_PER_MS 1000000UL
+  FORCE_INLINE uint32_t isr_profile_count() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint32_t(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+  }
+  FORCE_INLINE bool isr_profile_available() { return true; }
+#else
+  // The DWT cycle counter, enabled by calibrate_delay_loop()
+  #define ISR_PROFILE_UNIT   "cycles"
+  #define ISR_PROFILE_PER_MS ((F_CPU) / 1000UL)
+  FORCE_INLINE uint32_t isr_profile_count() { return *(volatile uint32_t *)0xE0001004; }
+  // Some parts have no DWT, or a DWT without CYCCNT (DWT_CTRL.NOCYCCNT)
+  FORCE_INLINE bool isr_profile_available() {
+    const uint32_t ctrl = *(volatile uint32_t *)0xE0001000;
+    return ctrl && !TEST(ctrl, 25);
+  }
+#endif
+
+typedef struct {
+  uint32_t count, min, max;
+  uint64_t total;
+
+  FORCE_INLINE void add(const uint32_t c) {
+    if (!count || c < min) min = c;
+    if (c > max) max = c;
+    count++;
+    total += c;
+  }
+  uint32_t avg() const { return count ? uint32_t(total / count) : 0; }
+} isr_stat_t;
+
+class ISRProfile {
+public:
+  enum Phase : uint8_t {
+    OPTITEM(FT_MOTION, PH_FT_MOTION)
+    OPTITEM(HAS_SHAPING, PH_SHAPING)
+    PH_PULSE,
+    OPTITEM(LIN_ADVANCE, PH_ADVANCE)
+    OPTITEM(INTEGRATED_BABYSTEPPING, PH_BABYSTEP)
+    PH_BLOCK,
+    PH_ISR,           // The whole ISR, with all its loops
+    PHASES
+  };
+
+  static isr_stat_t stats[PHASES];
+  static uint32_t overruns;       // ISRs that gave up after 10 loops without catching up
+  static millis_t since_ms;
+
+  FORCE_INLINE static void add(const Phase p, const uint32_t c) { stats[p].add(c); }
+
+  static void reset();
+  static void report(const bool full=true);
+
+  struct AutoReportISR { static void report() { ISRProfile::report(false); } };
+  static AutoReporter<AutoReportISR> auto_reporter;
+};
+
+extern ISRProfile isr_profile;
+
+// Time a statement of the stepper ISR
+#define ISR_PROFILED(P, V...) do{ const uint32_t _isr_t0 = isr_profile_count(); V; ISRProfile::add(ISRProfile::P, isr_profile_count() - _isr_t0); }while(0)
@@ -1480,6 +1480,11 @@ void Temperature::mintemp_error(const heater_id_t heater_id) {
         ambient_xfer_coeff += fan_fraction * constants.fan255_adjustment;
       #endif
 
+      #if ENABLED(MPC_FLOW_FEEDFORWARD)
+        // Plan power for the flow of the moves ahead, what is left of the current one included
+        float planned_xfer_coeff = ambient_xfer_coeff;
+      #endif
+
       if (this_hotend) {
         const int32_t e_position = stepper.position(E_AXIS);
         const float e_speed = (e_position - mpc_e_position) * planner.mm_per_step[E_AXIS] / MPC_dT;
@@ -1491,6 +1496,7 @@ void Temperature::mintemp_error(const heater_id_t heater_id) {
           ambient_xfer_coeff += e_speed * constants.filament_heat_capacity_permm;
           mpc_e_position = e_position;
         }
+        TERN_(MPC_FLOW_FEEDFORWARD, planned_xfer_coeff += planner.upcoming_e_speed(ee, MPC_FLOW_LOOKAHEAD) * constants.filament_heat_capacity_permm);
       }
 
       // Update the modeled temperatures
@@ -1515,7 +1521,7 @@ void Temperature::mintemp_error(const heater_id_t heater_id) {
       if (hotend.target != 0 && !is_idling) {
         // Plan power level to get to target temperature in 2 seconds
         power = (hotend.target - hotend.modeled_block_temp) * constants.block_heat_capacity / 2.0f;
-        power -= (hotend.modeled_ambient_temp - hotend.modeled_block_temp) * ambient_xfer_coeff;
+        power -= (hotend.modeled_ambient_temp - hotend.modeled_block_temp) * TERN(MPC_FLOW_FEEDFORWARD, planned_xfer_coeff, ambient_xfer_coeff);
       }
 
       float pid_output = power * 254.0f / constants.heater_power + 1.0f;        // Ensure correct quantization into a range of 0 to 127
@@ -1974,27 +1980,101 @@ void Temperature::task() {
 #define TEMP_AD595(RAW)  ((RAW) * 5.0 * 100.0 / float(HAL_ADC_RANGE) / (OVERSAMPLENR) * (TEMP_SENSOR_AD595_GAIN) + TEMP_SENSOR_AD595_OFFSET)
 #define TEMP_AD8495(RAW) ((RAW) * 6.6 * 100.0 / float(HAL_ADC_RANGE) / (OVERSAMPLENR) * (TEMP_SENSOR_AD8495_GAIN) + TEMP_SENSOR_AD8495_OFFSET)
 
-/**
- * Bisect search for the range of the 'raw' value, then interpolate
- * proportionally between the under and over values.
- */
-#define SCAN_THERMISTOR_TABLE(TBL,LEN) do{                                \
-  uint8_t l = 0, r = LEN, m;                                              \
-  for (;;) {                                                              \
-    m = (l + r) >> 1;                                                     \
-    if (!m) return celsius_t(pgm_read_word(&TBL[0].celsius));             \
-    if (m == l || m == r) return celsius_t(pgm_read_word(&TBL[LEN-1].celsius)); \
-    raw_adc_t v00 = pgm_read_word(&TBL[m-1].value),                       \
-              v10 = pgm_read_word(&TBL[m-0].value);                       \
-         if (raw < v00) r = m;                                            \
-    else if (raw > v10) l = m;                                            \
-    else {                                                                \
-      const celsius_t v01 = celsius_t(pgm_read_word(&TBL[m-1].celsius)),  \
-                      v11 = celsius_t(pgm_read_word(&TBL[m-0].celsius));  \
-      return v01 + (raw - v00) * float(v11 - v01) / float(v10 - v00);     \
-    }                                                                     \
-  }                                                                       \
-}while(0)
+#if ENABLED(THERMISTOR_TABLE_INDEX)
+
+  #define _TT_INDEX(N) constexpr temp_index_t tempindex_##N PROGMEM = TT_MAKE_INDEX(TEMPTABLE_##N)
+  #if TEMP_SENSOR_0_IS_THERMISTOR
+    _TT_INDEX(0);
+  #endif
+  #if TEMP_SENSOR_1_IS_THERMISTOR
+    _TT_INDEX(1);
+  #endif
+  #if TEMP_SENSOR_2_IS_THERMISTOR
+    _TT_INDEX(2);
+  #endif
+  #if TEMP_SENSOR_3_IS_THERMISTOR
+    _TT_INDEX(3);
+  #endif
+  #if TEMP_SENSOR_4_IS_THERMISTOR
+    _TT_INDEX(4);
+  #endif
+  #if TEMP_SENSOR_5_IS_THERMISTOR
+    _TT_INDEX(5);
+  #endif
+  #if TEMP_SENSOR_6_IS_THERMISTOR
+    _TT_INDEX(6);
+  #endif
+  #if TEMP_SENSOR_7_IS_THERMISTOR
+    _TT_INDEX(7);
+  #endif
+  #if TEMP_SENSOR_BED_IS_THERMISTOR
+    _TT_INDEX(BED);
+  #endif
+  #if TEMP_SENSOR_CHAMBER_IS_THERMISTOR
+    _TT_INDEX(CHAMBER);
+  #endif
+  #if TEMP_SENSOR_COOLER_IS_THERMISTOR
+    _TT_INDEX(COOLER);
+  #endif
+  #if TEMP_SENSOR_PROBE_IS_THERMISTOR
+    _TT_INDEX(PROBE);
+  #endif
+  #if TEMP_SENSOR_BOARD_IS_THERMISTOR
+    _TT_INDEX(BOARD);
+  #endif
+  #if TEMP_SENSOR_REDUNDANT_IS_THERMISTOR
+    _TT_INDEX(REDUNDANT);
+  #endif
+  #undef _TT_INDEX
+
+  #if HAS_HOTEND_THERMISTOR
+    #define _TT_INDEX_PTR(N) TERN(TEMP_SENSOR_##N##_IS_THERMISTOR, &tempindex_##N, nullptr)
+    #define NEXT_TT_INDEX_PTR(N) ,_TT_INDEX_PTR(N)
+    static const temp_index_t * const heater_ttidx_map[HOTENDS] = ARRAY_BY_HOTENDS(_TT_INDEX_PTR(0) REPEAT_S(1, HOTENDS, NEXT_TT_INDEX_PTR));
+  #endif
+
+  /**
+   * Start at the indexed entry for the 'raw' value's slice and step up to the
+   * first entry at or above it, then interpolate proportionally between the
+   * under and over values.
+   */
+  #define SCAN_THERMISTOR_TABLE(TBL,LEN,IDX) do{                            \
+    uint8_t i = pgm_read_byte(&(IDX).first[raw >> (TT_INDEX_SHIFT)]);       \
+    while (i < LEN && raw > raw_adc_t(pgm_read_word(&TBL[i].value))) i++;   \
+    if (!i) return celsius_t(pgm_read_word(&TBL[0].celsius));               \
+    if (i == LEN) return celsius_t(pgm_read_word(&TBL[LEN-1].celsius));     \
+    const raw_adc_t v00 = pgm_read_word(&TBL[i-1].value),                   \
+                    v10 = pgm_read_word(&TBL[i-0].value);                   \
+    const celsius_t v01 = celsius_t(pgm_read_word(&TBL[i-1].celsius)),      \
+                    v11 = celsius_t(pgm_read_word(&TBL[i-0].celsius));      \
+    return v01 + (raw - v00) * float(v11 - v01) / float(v10 - v00);         \
+  }while(0)
+
+#else
+
+  /**
+   * Bisect search for the range of the 'raw' value, then interpolate
+   * proportionally between the under and over values.
+   */
+  #define SCAN_THERMISTOR_TABLE(TBL,LEN,IDX) do{                            \
+    uint8_t l = 0, r = LEN, m;                                              \
+    for (;;) {                                                              \
+      m = (l + r) >> 1;                                                     \
+      if (!m) return celsius_t(pgm_read_word(&TBL[0].celsius));             \
+      if (m == l || m == r) return celsius_t(pgm_read_word(&TBL[LEN-1].celsius)); \
+      raw_adc_t v00 = pgm_read_word(&TBL[m-1].value),                       \
+                v10 = pgm_read_word(&TBL[m-0].value);                       \
+           if (raw < v00) r = m;                                            \
+      else if (raw > v10) l = m;                                            \
+      else {                                                                \
+        const celsius_t v01 = celsius_t(pgm_read_word(&TBL[m-1].celsius)),  \
+                        v11 = celsius_t(pgm_read_word(&TBL[m-0].celsius));  \
+        return v01 + (raw - v00) * float(v11 - v01) / float(v10 - v00);     \
+      }                                                                     \
+    }                                                                       \
+  }while(0)
+
+#endif
 
 #if HAS_USER_THERMISTORS
 
@@ -2238,7 +2318,7 @@ void Temperature::task() {
     #if HAS_HOTEND_THERMISTOR
       // Thermistor with conversion table?
       const temp_entry_t(*tt)[] = (temp_entry_t(*)[])(heater_ttbl_map[e]);
-      SCAN_THERMISTOR_TABLE((*tt), heater_ttbllen_map[e]);
+      SCAN_THERMISTOR_TABLE((*tt), heater_ttbllen_map[e], *heater_ttidx_map[e]);
     #endif
 
     return 0;
@@ -2251,7 +2331,7 @@ void Temperature::task() {
     #if TEMP_SENSOR_BED_IS_CUSTOM
       return user_thermistor_to_deg_c(CTI_BED, raw);
     #elif TEMP_SENSOR_BED_IS_THERMISTOR
-      SCAN_THERMISTOR_TABLE(TEMPTABLE_BED, TEMPTABLE_BED_LEN);
+      SCAN_THERMISTOR_TABLE(TEMPTABLE_BED, TEMPTABLE_BED_LEN, tempindex_BED);
     #elif TEMP_SENSOR_BED_IS_AD595
       return TEMP_AD595(raw);
     #elif TEMP_SENSOR_BED_IS_AD8495
@@ -2269,7 +2349,7 @@ void Temperature::task() {
     #if TEMP_SENSOR_CHAMBER_IS_CUSTOM
       return user_thermistor_to_deg_c(CTI_CHAMBER, raw);
     #elif TEMP_SENSOR_CHAMBER_IS_THERMISTOR
-      SCAN_THERMISTOR_TABLE(TEMPTABLE_CHAMBER, TEMPTABLE_CHAMBER_LEN);
+      SCAN_THERMISTOR_TABLE(TEMPTABLE_CHAMBER, TEMPTABLE_CHAMBER_LEN, tempindex_CHAMBER);
     #elif TEMP_SENSOR_CHAMBER_IS_AD595
       return TEMP_AD595(raw);
     #elif TEMP_SENSOR_CHAMBER_IS_AD8495
@@ -2287,7 +2367,7 @@ void Temperature::task() {
     #if TEMP_SENSOR_COOLER_IS_CUSTOM
       return user_thermistor_to_deg_c(CTI_COOLER, raw);
     #elif TEMP_SENSOR_COOLER_IS_THERMISTOR
-      SCAN_THERMISTOR_TABLE(TEMPTABLE_COOLER, TEMPTABLE_COOLER_LEN);
+      SCAN_THERMISTOR_TABLE(TEMPTABLE_COOLER, TEMPTABLE_COOLER_LEN, tempindex_COOLER);
     #elif TEMP_SENSOR_COOLER_IS_AD595
       return TEMP_AD595(raw);
     #elif TEMP_SENSOR_COOLER_IS_AD8495
@@ -2305,7 +2385,7 @@ void Temperature::task() {
     #if TEMP_SENSOR_PROBE_IS_CUSTOM
       return user_thermistor_to_deg_c(CTI_PROBE, raw);
     #elif TEMP_SENSOR_PROBE_IS_THERMISTOR
-      SCAN_THERMISTOR_TABLE(TEMPTABLE_PROBE, TEMPTABLE_PROBE_LEN);
+      SCAN_THERMISTOR_TABLE(TEMPTABLE_PROBE, TEMPTABLE_PROBE_LEN, tempindex_PROBE);
     #elif TEMP_SENSOR_PROBE_IS_AD595
       return TEMP_AD595(raw);
     #elif TEMP_SENSOR_PROBE_IS_AD8495
@@ -2323,7 +2403,7 @@ void Temperature::task() {
     #if TEMP_SENSOR_BOARD_IS_CUSTOM
       return user_thermistor_to_deg_c(CTI_BOARD, raw);
     #elif TEMP_SENSOR_BOARD_IS_THERMISTOR
-      SCAN_THERMISTOR_TABLE(TEMPTABLE_BOARD, TEMPTABLE_BOARD_LEN);
+      SCAN_THERMISTOR_TABLE(TEMPTABLE_BOARD, TEMPTABLE_BOARD_LEN, tempindex_BOARD);
     #elif TEMP_SENSOR_BOARD_IS_AD595
       return TEMP_AD595(raw);
     #elif TEMP_SENSOR_BOARD_IS_AD8495
@@ -2347,7 +2427,7 @@ void Temperature::task() {
     #elif TEMP_SENSOR_IS_MAX_TC(REDUNDANT) && REDUNDANT_TEMP_MATCH(SOURCE, E2)
       return TERN(TEMP_SENSOR_REDUNDANT_IS_MAX31865, max31865_2.temperature(raw), (int16_t)raw * 0.25);
     #elif TEMP_SENSOR_REDUNDANT_IS_THERMISTOR
-      SCAN_THERMISTOR_TABLE(TEMPTABLE_REDUNDANT, TEMPTABLE_REDUNDANT_LEN);
+      SCAN_THERMISTOR_TABLE(TEMPTABLE_REDUNDANT, TEMPTABLE_REDUNDANT_LEN, tempindex_REDUNDANT);
     #elif TEMP_SENSOR_REDUNDANT_IS_AD595
       return TEMP_AD595(raw);
     #elif TEMP_SENSOR_REDUNDANT_IS_AD8495
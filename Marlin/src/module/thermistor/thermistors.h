@@ -215,6 +215,36 @@ typedef struct { raw_adc_t value; celsius_t celsius; } temp_entry_t;
 #define _TT_NAME(_N) temptable_ ## _N
 #define TT_NAME(_N) _TT_NAME(_N)
 
+#if ENABLED(THERMISTOR_TABLE_INDEX)
+  /**
+   * A thermistor table index, built at compile time. The raw range is cut into
+   * 2^THERMISTOR_INDEX_BITS equal slices, each with the first table entry at or
+   * above its start, so the entries around a raw value are a shift and a step
+   * or two away.
+   */
+  constexpr uint8_t tt_log2(const uint32_t n) { return n > 1 ? 1 + tt_log2(n >> 1) : 0; }
+  #define TT_INDEX_CELLS _BV(THERMISTOR_INDEX_BITS)
+  #define TT_INDEX_SHIFT (tt_log2(uint32_t(MAX_RAW_THERMISTOR_VALUE) + 1) - (THERMISTOR_INDEX_BITS))
+
+  typedef struct { uint8_t first[TT_INDEX_CELLS]; } temp_index_t;
+
+  // The first entry at or above a raw value
+  constexpr uint8_t tt_first(const temp_entry_t * const tbl, const uint8_t len, const uint32_t raw, const uint8_t i=0) {
+    return (i < len && tbl[i].value < raw) ? tt_first(tbl, len, raw, i + 1) : i;
+  }
+
+  template<uint8_t... C> struct tt_cells {};
+  template<uint16_t N, uint8_t... C> struct tt_make_cells : tt_make_cells<N - 1, N - 1, C...> {};
+  template<uint8_t... C> struct tt_make_cells<0, C...> { typedef tt_cells<C...> type; };
+
+  template<uint8_t... C>
+  constexpr temp_index_t tt_make_index(const temp_entry_t * const tbl, const uint8_t len, tt_cells<C...>) {
+    return { { tt_first(tbl, len, uint32_t(C) << (TT_INDEX_SHIFT))... } };
+  }
+
+  #define TT_MAKE_INDEX(TBL) tt_make_index(TBL, COUNT(TBL), tt_make_cells<TT_INDEX_CELLS>::type())
+#endif
+
 #if TEMP_SENSOR_0 > 0
   #define TEMPTABLE_0 TT_NAME(TEMP_SENSOR_0)
   #define TEMPTABLE_0_LEN COUNT(TEMPTABLE_0)
@@ -37,6 +37,7 @@
 // Startup tests are run at the end of setup()
 void runStartupTests() {
   // Call post-setup tests here to validate behaviors.
+  TERN_(PLANNER_FIXED_POINT, planner.test_fixed_point());
 }
 
 // Periodic tests are run from within loop()